@@ -0,0 +1,1052 @@
+/*
+  ==============================================================================
+
+    Benchmark.cpp
+    Created: 16 Oct 2026 4:12:30pm
+    Author:  Nate
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include <chrono>
+#include <complex>
+#include <functional>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/PluginEditor.h"
+#include "../../Source/FrequencyResponse.h"
+
+//==============================================================================
+// Every heap allocation in this executable goes through these, so a benchmark can tell how many
+// allocations the code it timed made. The count is per thread so worker threads don't pollute it.
+// They also report to the processor's RealtimeStats when the allocation happens inside processBlock.
+static thread_local juce::int64 numAllocations = 0;
+
+void countAllocation() {
+    ++numAllocations;
+    RealtimeStats::noteAllocation();
+}
+
+void* operator new(std::size_t size) {
+    countAllocation();
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { countAllocation(); return std::malloc(size == 0 ? 1 : size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { countAllocation(); return std::malloc(size == 0 ? 1 : size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    countAllocation();
+    std::size_t align = (std::size_t)alignment;
+    // aligned_alloc wants the size to be a multiple of the alignment
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+//==============================================================================
+const double BENCHMARK_SAMPLE_RATE = 48000.0;
+const int BENCHMARK_NUM_CHANNELS = 2;
+const int PROCESS_SAMPLES_PER_CASE = 1 << 18; // ~5.5s of audio per processBlock case
+const int ANALYZER_ITERATIONS = 200;
+const int RESPONSE_CURVE_ITERATIONS = 200;
+const int RESPONSE_CURVE_WIDTH = 560; // roughly the analysis area of the default editor size
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+double nanosecondsSince(BenchmarkClock::time_point start) {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(BenchmarkClock::now() - start).count();
+}
+
+void fillWithNoise(juce::AudioBuffer<float>& buffer) {
+    juce::Random random(1234);
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+        float* samples = buffer.getWritePointer(channel);
+        for (int i = 0; i < buffer.getNumSamples(); ++i) {
+            samples[i] = random.nextFloat() * 2.f - 1.f;
+        }
+    }
+}
+
+void setParameter(SimpleEQAudioProcessor& processor, const juce::String& name, float value) {
+    juce::RangedAudioParameter* param = processor.apvts.getParameter(name);
+    param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+struct BenchmarkResult {
+    juce::String name;
+    juce::NamedValueSet settings;
+    double nanosecondsPerCall;
+    double nanosecondsPerSample;
+    double allocationsPerCall;
+
+    juce::var toVar() const {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("name", name);
+        for (const juce::NamedValue& setting : settings) {
+            object->setProperty(setting.name, setting.value);
+        }
+        object->setProperty("nsPerCall", nanosecondsPerCall);
+        object->setProperty("nsPerSample", nanosecondsPerSample);
+        object->setProperty("allocationsPerCall", allocationsPerCall);
+        return juce::var(object);
+    }
+};
+
+//==============================================================================
+// The filters are set away from neutral so every band does real work when it isn't bypassed
+void benchmarkProcessBlock(juce::Array<BenchmarkResult>& results) {
+    SimpleEQAudioProcessor processor;
+    setParameter(processor, LOW_CUT_FREQ_NAME, 100.f);
+    setParameter(processor, HIGH_CUT_FREQ_NAME, 8000.f);
+    setParameter(processor, PEAK_FREQ_NAME, 1000.f);
+    setParameter(processor, PEAK_GAIN_NAME, 6.f);
+    setParameter(processor, PEAK_QUALITY_NAME, 1.f);
+
+    juce::AudioBuffer<float> source(BENCHMARK_NUM_CHANNELS, 4096);
+    fillWithNoise(source);
+    juce::MidiBuffer midi;
+    const juce::StringArray slopeNames{ "12", "24", "36", "48" };
+
+    for (int blockSize = 16; blockSize <= 4096; blockSize *= 2) {
+        juce::AudioBuffer<float> buffer(BENCHMARK_NUM_CHANNELS, blockSize);
+        int numCalls = PROCESS_SAMPLES_PER_CASE / blockSize;
+
+        // the buffer is refilled before every call so the peak boost can't run away, this times the refill alone to take it back out
+        BenchmarkClock::time_point copyStart = BenchmarkClock::now();
+        for (int call = 0; call < numCalls; ++call) {
+            for (int channel = 0; channel < BENCHMARK_NUM_CHANNELS; ++channel) {
+                buffer.copyFrom(channel, 0, source, channel, 0, blockSize);
+            }
+        }
+        double copyNanoseconds = nanosecondsSince(copyStart);
+
+        for (int slope = Slope_12; slope <= Slope_48; ++slope) {
+            for (int bypassMask = 0; bypassMask < 8; ++bypassMask) {
+                bool lowCutBypassed = (bypassMask & 1) != 0;
+                bool peakBypassed = (bypassMask & 2) != 0;
+                bool highCutBypassed = (bypassMask & 4) != 0;
+
+                setParameter(processor, LOW_CUT_SLOPE_NAME, (float)slope);
+                setParameter(processor, HIGH_CUT_SLOPE_NAME, (float)slope);
+                setParameter(processor, LOW_CUT_BYPASS_NAME, lowCutBypassed ? 1.f : 0.f);
+                setParameter(processor, PEAK_BYPASS_NAME, peakBypassed ? 1.f : 0.f);
+                setParameter(processor, HIGH_CUT_BYPASS_NAME, highCutBypassed ? 1.f : 0.f);
+
+                // prepareToPlay designs and applies the coefficients straight away, no timer needed
+                processor.setRateAndBufferSizeDetails(BENCHMARK_SAMPLE_RATE, blockSize);
+                processor.prepareToPlay(BENCHMARK_SAMPLE_RATE, blockSize);
+
+                // warm up caches and branch predictors
+                for (int call = 0; call < juce::jmin(numCalls, 64); ++call) {
+                    for (int channel = 0; channel < BENCHMARK_NUM_CHANNELS; ++channel) {
+                        buffer.copyFrom(channel, 0, source, channel, 0, blockSize);
+                    }
+                    processor.processBlock(buffer, midi);
+                }
+
+                juce::int64 allocationsBefore = numAllocations;
+                BenchmarkClock::time_point start = BenchmarkClock::now();
+                for (int call = 0; call < numCalls; ++call) {
+                    for (int channel = 0; channel < BENCHMARK_NUM_CHANNELS; ++channel) {
+                        buffer.copyFrom(channel, 0, source, channel, 0, blockSize);
+                    }
+                    processor.processBlock(buffer, midi);
+                }
+                double nanoseconds = juce::jmax(0.0, nanosecondsSince(start) - copyNanoseconds);
+                juce::int64 allocations = numAllocations - allocationsBefore;
+
+                processor.releaseResources();
+
+                BenchmarkResult result;
+                result.name = "processBlock";
+                result.settings.set("blockSize", blockSize);
+                result.settings.set("slope", slopeNames[slope] + DB_PER_OCT);
+                result.settings.set("lowCutBypassed", lowCutBypassed);
+                result.settings.set("peakBypassed", peakBypassed);
+                result.settings.set("highCutBypassed", highCutBypassed);
+                result.nanosecondsPerCall = nanoseconds / numCalls;
+                // per sample frame, both channels together
+                result.nanosecondsPerSample = nanoseconds / ((double)numCalls * blockSize);
+                result.allocationsPerCall = (double)allocations / numCalls;
+                results.add(result);
+            }
+        }
+    }
+}
+
+//==============================================================================
+// Flat band elimination on and off, for two states:
+// "neutral" has the cuts switched off and a 0dB peak, so with elimination the cascade runs no stages at all and the block
+// passes straight through, against the one peak biquad it would otherwise run.
+// "defaults" is a freshly inserted instance, whose cuts at 20Hz and 20KHz still take 3dB off at the ends of the audible band,
+// so elimination only drops the peak and two of its three biquads keep running.
+void benchmarkNeutralProcessBlock(juce::Array<BenchmarkResult>& results) {
+    juce::AudioBuffer<float> source(BENCHMARK_NUM_CHANNELS, 4096);
+    fillWithNoise(source);
+    juce::MidiBuffer midi;
+
+    for (bool neutral : { true, false }) {
+        for (bool eliminateFlatBands : { true, false }) {
+            SimpleEQAudioProcessor processor;
+            processor.setFlatBandTolerance(eliminateFlatBands ? FLAT_BAND_TOLERANCE_DB : -1.f);
+            if (neutral) {
+                setParameter(processor, LOW_CUT_BYPASS_NAME, 1.f);
+                setParameter(processor, HIGH_CUT_BYPASS_NAME, 1.f);
+            }
+
+            for (int blockSize = 16; blockSize <= 4096; blockSize *= 2) {
+                juce::AudioBuffer<float> buffer(BENCHMARK_NUM_CHANNELS, blockSize);
+                int numCalls = PROCESS_SAMPLES_PER_CASE / blockSize;
+
+                processor.setRateAndBufferSizeDetails(BENCHMARK_SAMPLE_RATE, blockSize);
+                processor.prepareToPlay(BENCHMARK_SAMPLE_RATE, blockSize);
+
+                BenchmarkClock::time_point copyStart = BenchmarkClock::now();
+                for (int call = 0; call < numCalls; ++call) {
+                    for (int channel = 0; channel < BENCHMARK_NUM_CHANNELS; ++channel) {
+                        buffer.copyFrom(channel, 0, source, channel, 0, blockSize);
+                    }
+                }
+                double copyNanoseconds = nanosecondsSince(copyStart);
+
+                juce::int64 allocationsBefore = numAllocations;
+                BenchmarkClock::time_point start = BenchmarkClock::now();
+                for (int call = 0; call < numCalls; ++call) {
+                    for (int channel = 0; channel < BENCHMARK_NUM_CHANNELS; ++channel) {
+                        buffer.copyFrom(channel, 0, source, channel, 0, blockSize);
+                    }
+                    processor.processBlock(buffer, midi);
+                }
+                double nanoseconds = juce::jmax(0.0, nanosecondsSince(start) - copyNanoseconds);
+                juce::int64 allocations = numAllocations - allocationsBefore;
+
+                processor.releaseResources();
+
+                BenchmarkResult result;
+                result.name = "processBlock (neutral)";
+                result.settings.set("blockSize", blockSize);
+                result.settings.set("state", neutral ? "neutral" : "defaults");
+                result.settings.set("flatBandElimination", eliminateFlatBands);
+                result.nanosecondsPerCall = nanoseconds / numCalls;
+                result.nanosecondsPerSample = nanoseconds / ((double)numCalls * blockSize);
+                result.allocationsPerCall = (double)allocations / numCalls;
+                results.add(result);
+            }
+        }
+    }
+}
+
+//==============================================================================
+// One instance on buses from mono up to MAX_PROCESS_CHANNELS, every band active at 12dB/Oct with 512 sample blocks.
+// Each result also gives its cost against the stereo instances the same bus would otherwise need.
+void benchmarkChannelCounts(juce::Array<BenchmarkResult>& results) {
+    const int blockSize = 512;
+    const int numCalls = PROCESS_SAMPLES_PER_CASE / blockSize;
+    juce::MidiBuffer midi;
+    double stereoNanosecondsPerCall = 0.0;
+
+    for (int numChannels : { 1, 2, 6, 12, MAX_PROCESS_CHANNELS }) {
+        SimpleEQAudioProcessor processor;
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+        layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+        if (!processor.setBusesLayout(layout)) {
+            std::cerr << numChannels << " channel layout was rejected" << std::endl;
+            continue;
+        }
+
+        setParameter(processor, LOW_CUT_FREQ_NAME, 100.f);
+        setParameter(processor, HIGH_CUT_FREQ_NAME, 8000.f);
+        setParameter(processor, PEAK_FREQ_NAME, 1000.f);
+        setParameter(processor, PEAK_GAIN_NAME, 6.f);
+        processor.setRateAndBufferSizeDetails(BENCHMARK_SAMPLE_RATE, blockSize);
+        processor.prepareToPlay(BENCHMARK_SAMPLE_RATE, blockSize);
+
+        juce::AudioBuffer<float> source(numChannels, blockSize);
+        fillWithNoise(source);
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+
+        BenchmarkClock::time_point copyStart = BenchmarkClock::now();
+        for (int call = 0; call < numCalls; ++call) {
+            buffer.makeCopyOf(source, true);
+        }
+        double copyNanoseconds = nanosecondsSince(copyStart);
+
+        juce::int64 allocationsBefore = numAllocations;
+        BenchmarkClock::time_point start = BenchmarkClock::now();
+        for (int call = 0; call < numCalls; ++call) {
+            buffer.makeCopyOf(source, true);
+            processor.processBlock(buffer, midi);
+        }
+        double nanoseconds = juce::jmax(0.0, nanosecondsSince(start) - copyNanoseconds);
+        juce::int64 allocations = numAllocations - allocationsBefore;
+
+        processor.releaseResources();
+
+        BenchmarkResult result;
+        result.name = "processBlock (channels)";
+        result.settings.set("blockSize", blockSize);
+        result.settings.set("numChannels", numChannels);
+        result.nanosecondsPerCall = nanoseconds / numCalls;
+        result.nanosecondsPerSample = nanoseconds / ((double)numCalls * blockSize);
+        result.allocationsPerCall = (double)allocations / numCalls;
+
+        if (numChannels == 2) {
+            stereoNanosecondsPerCall = result.nanosecondsPerCall;
+        }
+        if (numChannels > 2 && stereoNanosecondsPerCall > 0.0) {
+            int numStereoInstances = (numChannels + 1) / 2;
+            result.settings.set("shareOfStereoInstances", result.nanosecondsPerCall / (numStereoInstances * stereoNanosecondsPerCall));
+        }
+        results.add(result);
+    }
+}
+
+//==============================================================================
+// Plain float Direct Form I, one section after another over the whole block: the baseline the cascade's modes are compared to
+void processFloatDirectForm(const std::vector<BiquadCoefficients<double>>& sections, float* samples, int numSamples) {
+    for (const BiquadCoefficients<double>& section : sections) {
+        BiquadCoefficients<float> c = section.convertedTo<float>();
+        float x1 = 0.f, x2 = 0.f, y1 = 0.f, y2 = 0.f;
+        for (int i = 0; i < numSamples; ++i) {
+            float x = samples[i];
+            float y = c.b0 * x + c.b1 * x1 + c.b2 * x2 - c.a1 * y1 - c.a2 * y2;
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            samples[i] = y;
+        }
+    }
+}
+
+// The same sections in long double, what every mode's output is measured against
+void processReference(const std::vector<BiquadCoefficients<double>>& sections, const float* input, std::vector<long double>& output) {
+    for (size_t i = 0; i < output.size(); ++i) {
+        output[i] = input[i];
+    }
+    for (const BiquadCoefficients<double>& c : sections) {
+        long double z1 = 0.0L, z2 = 0.0L;
+        for (long double& sample : output) {
+            long double x = sample;
+            long double y = c.b0 * x + z1;
+            z1 = c.b1 * x - c.a1 * y + z2;
+            z2 = c.b2 * x - c.a2 * y;
+            sample = y;
+        }
+    }
+}
+
+// Cost and accuracy of each FilterMode running the whole cascade, against the float direct form, at cutoffs low enough
+// for float coefficients and state to go wrong: a 48dB/Oct low cut at 20Hz and a 12dB bell at 30Hz, at 48 and 192KHz.
+// The error is the RMS of the difference from a long double reference, in dB relative to the reference's own RMS.
+void benchmarkFilterModes(juce::Array<BenchmarkResult>& results) {
+    const int numSamples = PROCESS_SAMPLES_PER_CASE;
+    const int blockSize = 512;
+    const juce::StringArray modeNames{ "Float Direct Form I", FILTER_MODE_CHOICES[Mode_FloatTDF2], FILTER_MODE_CHOICES[Mode_DoubleTDF2],
+                                       FILTER_MODE_CHOICES[Mode_FloatSVF] };
+
+    juce::AudioBuffer<float> source(BENCHMARK_NUM_CHANNELS, numSamples);
+    fillWithNoise(source);
+    juce::AudioBuffer<float> buffer(BENCHMARK_NUM_CHANNELS, numSamples);
+    std::vector<long double> reference((size_t)numSamples);
+
+    for (double sampleRate : { 48000.0, 192000.0 }) {
+        ChainSettings chainSettings;
+        chainSettings.lowCutFreq = 20.f;
+        chainSettings.lowCutSlope = Slope_48;
+        chainSettings.peakFreq = 30.f;
+        chainSettings.peakGainInDecibels = 12.f;
+        chainSettings.peakQuality = 1.f;
+        chainSettings.highCutBypassed = true;
+
+        ChainCoefficients chainCoefficients;
+        designLowCut(chainCoefficients, chainSettings, sampleRate);
+        designPeak(chainCoefficients, chainSettings, sampleRate);
+
+        int numLowCutStages = getNumActiveStages(chainSettings.lowCutSlope, chainSettings.lowCutBypassed);
+        std::vector<BiquadCoefficients<double>> sections;
+        for (int i = 0; i < numLowCutStages; ++i) {
+            sections.push_back(chainCoefficients.lowCut[(size_t)i].biquad);
+        }
+        sections.push_back(chainCoefficients.peak.biquad);
+
+        processReference(sections, source.getReadPointer(0), reference);
+        long double referencePower = 0.0L;
+        for (long double sample : reference) {
+            referencePower += sample * sample;
+        }
+
+        for (int mode = -1; mode <= Mode_FloatSVF; ++mode) {
+            buffer.makeCopyOf(source, true);
+
+            FilterCascade cascade;
+            if (mode >= 0) {
+                cascade.prepare(blockSize);
+                cascade.setLowCut(chainCoefficients.lowCut, numLowCutStages, (FilterMode)mode);
+                cascade.setPeak(chainCoefficients.peak, true, (FilterMode)mode);
+                cascade.setHighCut(chainCoefficients.highCut, 0, (FilterMode)mode);
+            }
+
+            juce::int64 allocationsBefore = numAllocations;
+            BenchmarkClock::time_point start = BenchmarkClock::now();
+            if (mode < 0) {
+                for (int channel = 0; channel < BENCHMARK_NUM_CHANNELS; ++channel) {
+                    processFloatDirectForm(sections, buffer.getWritePointer(channel), numSamples);
+                }
+            }
+            else {
+                std::array<float*, BENCHMARK_NUM_CHANNELS> channels;
+                for (int offset = 0; offset < numSamples; offset += blockSize) {
+                    for (int channel = 0; channel < BENCHMARK_NUM_CHANNELS; ++channel) {
+                        channels[(size_t)channel] = buffer.getWritePointer(channel, offset);
+                    }
+                    cascade.process(channels.data(), BENCHMARK_NUM_CHANNELS, juce::jmin(blockSize, numSamples - offset));
+                }
+            }
+            double nanoseconds = nanosecondsSince(start);
+            juce::int64 allocations = numAllocations - allocationsBefore;
+
+            // both channels got the same treatment, so the first one stands for them
+            const float* output = buffer.getReadPointer(0);
+            long double errorPower = 0.0L;
+            long double maxError = 0.0L;
+            for (int i = 0; i < numSamples; ++i) {
+                long double error = (long double)output[i] - reference[(size_t)i];
+                errorPower += error * error;
+                maxError = juce::jmax(maxError, std::abs(error));
+            }
+
+            BenchmarkResult result;
+            result.name = "filter modes";
+            result.settings.set("sampleRate", sampleRate);
+            result.settings.set("mode", modeNames[mode + 1]);
+            result.settings.set("rmsErrorDb", 10.0 * std::log10((double)juce::jmax(errorPower / referencePower, 1.0e-30L)));
+            result.settings.set("maxError", (double)maxError);
+            // one "call" is one blockSize worth of samples, both channels together
+            int numCalls = numSamples / blockSize;
+            result.nanosecondsPerCall = nanoseconds / numCalls;
+            result.nanosecondsPerSample = nanoseconds / numSamples;
+            result.allocationsPerCall = (double)allocations / numCalls;
+            results.add(result);
+        }
+    }
+}
+
+//==============================================================================
+// The two SingleChannelSampleFifo::update calls at the end of processBlock, with a reader that keeps up.
+// Each result also gives the tap's share of a full processBlock at the same block size with every band at 12dB/Oct.
+// The processBlock cases run headless with no analyzer subscribed, so they don't include the tap themselves.
+void benchmarkAnalyzerTap(juce::Array<BenchmarkResult>& results) {
+    juce::AudioBuffer<float> source(BENCHMARK_NUM_CHANNELS, 4096);
+    fillWithNoise(source);
+
+    for (int blockSize = 16; blockSize <= 4096; blockSize *= 2) {
+        SingleChannelSampleFifo<juce::AudioBuffer<float>> leftChannelFifo{ Channel::Left };
+        SingleChannelSampleFifo<juce::AudioBuffer<float>> rightChannelFifo{ Channel::Right };
+        leftChannelFifo.prepare(blockSize);
+        rightChannelFifo.prepare(blockSize);
+
+        // refers to the start of source rather than copying it
+        juce::AudioBuffer<float> block(source.getArrayOfWritePointers(), BENCHMARK_NUM_CHANNELS, blockSize);
+        int numCalls = PROCESS_SAMPLES_PER_CASE / blockSize;
+
+        juce::int64 allocationsBefore = numAllocations;
+        BenchmarkClock::time_point start = BenchmarkClock::now();
+        for (int call = 0; call < numCalls; ++call) {
+            leftChannelFifo.update(block);
+            rightChannelFifo.update(block);
+            // the analyzer's side, only moves the read index
+            leftChannelFifo.skipSamples(blockSize);
+            rightChannelFifo.skipSamples(blockSize);
+        }
+        double nanoseconds = nanosecondsSince(start);
+        juce::int64 allocations = numAllocations - allocationsBefore;
+
+        BenchmarkResult result;
+        result.name = "SingleChannelSampleFifo::update";
+        result.settings.set("blockSize", blockSize);
+        result.nanosecondsPerCall = nanoseconds / numCalls;
+        result.nanosecondsPerSample = nanoseconds / ((double)numCalls * blockSize);
+        result.allocationsPerCall = (double)allocations / numCalls;
+
+        for (const BenchmarkResult& processResult : results) {
+            if (processResult.name == "processBlock"
+                && (int)processResult.settings["blockSize"] == blockSize
+                && processResult.settings["slope"].toString() == "12" + DB_PER_OCT
+                && !(bool)processResult.settings["lowCutBypassed"]
+                && !(bool)processResult.settings["peakBypassed"]
+                && !(bool)processResult.settings["highCutBypassed"]
+                && processResult.nanosecondsPerCall > 0.0) {
+                result.settings.set("shareOfProcessBlock", result.nanosecondsPerCall / processResult.nanosecondsPerCall);
+            }
+        }
+        results.add(result);
+    }
+}
+
+//==============================================================================
+// The analysis as it was before the fused kernel: zero fill, window, transform, then separate normalise and decibel passes.
+// Kept as the baseline that produceFFtDataForRendering is compared against.
+struct ReferenceFFTAnalysis {
+    ReferenceFFTAnalysis(int order) : fft(order), window((size_t)(1 << order), juce::dsp::WindowingFunction<float>::blackmanHarris) {
+        fftData.resize((size_t)(2 << order), 0.f);
+    }
+
+    void process(const juce::AudioBuffer<float>& audioData, float negativeInfinity) {
+        const int fftSize = fft.getSize();
+        fftData.assign(fftData.size(), 0);
+        const float* readIndex = audioData.getReadPointer(0);
+        std::copy(readIndex, readIndex + fftSize, fftData.begin());
+
+        window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+        fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+        int numBins = fftSize / 2;
+        for (int i = 0; i < numBins; ++i) {
+            fftData[i] /= (float)numBins;
+        }
+        for (int i = 0; i < numBins; ++i) {
+            fftData[i] = juce::Decibels::gainToDecibels(fftData[i], negativeInfinity);
+        }
+    }
+
+    juce::dsp::FFT fft;
+    juce::dsp::WindowingFunction<float> window;
+    std::vector<float> fftData;
+};
+
+//==============================================================================
+void benchmarkAnalyzer(juce::Array<BenchmarkResult>& results) {
+    const juce::Rectangle<float> fftBounds(0.f, 0.f, (float)RESPONSE_CURVE_WIDTH, 200.f);
+    const std::array<FFTOrder, 3> orders{ order2048, order4096, order8192 };
+
+    for (FFTOrder order : orders) {
+        FFTDataGenerator<std::vector<float>> fftDataGenerator;
+        fftDataGenerator.changeOrder(order);
+        int fftSize = fftDataGenerator.getFFtSize();
+
+        juce::AudioBuffer<float> monoBuffer(1, fftSize);
+        fillWithNoise(monoBuffer);
+        std::vector<float> fftData(fftSize * 2, 0.f);
+
+        // pulling each block straight back out keeps the fifo from filling up and skipping the copy
+        juce::int64 allocationsBefore = numAllocations;
+        BenchmarkClock::time_point start = BenchmarkClock::now();
+        for (int i = 0; i < ANALYZER_ITERATIONS; ++i) {
+            fftDataGenerator.produceFFtDataForRendering(monoBuffer, ABSOLUTE_MINIMUM_GAIN);
+            fftDataGenerator.getFFTData(fftData);
+        }
+        double nanoseconds = nanosecondsSince(start);
+        juce::int64 allocations = numAllocations - allocationsBefore;
+
+        ReferenceFFTAnalysis reference(order);
+        BenchmarkClock::time_point referenceStart = BenchmarkClock::now();
+        for (int i = 0; i < ANALYZER_ITERATIONS; ++i) {
+            reference.process(monoBuffer, ABSOLUTE_MINIMUM_GAIN);
+        }
+        double referenceNanoseconds = nanosecondsSince(referenceStart);
+
+        // both ran on the same input, so their last outputs should agree to well within a pixel
+        float maxErrorDb = 0.f;
+        for (int bin = 0; bin < fftSize / 2; ++bin) {
+            maxErrorDb = juce::jmax(maxErrorDb, std::abs(fftData[(size_t)bin] - reference.fftData[(size_t)bin]));
+        }
+
+        BenchmarkResult fftResult;
+        fftResult.name = "FFTDataGenerator::produceFFtDataForRendering";
+        fftResult.settings.set("fftSize", fftSize);
+        fftResult.settings.set("referenceNsPerCall", referenceNanoseconds / ANALYZER_ITERATIONS);
+        fftResult.settings.set("speedupOverReference", nanoseconds > 0.0 ? referenceNanoseconds / nanoseconds : 0.0);
+        fftResult.settings.set("maxErrorDb", maxErrorDb);
+        fftResult.nanosecondsPerCall = nanoseconds / ANALYZER_ITERATIONS;
+        fftResult.nanosecondsPerSample = fftResult.nanosecondsPerCall / fftSize;
+        fftResult.allocationsPerCall = (double)allocations / ANALYZER_ITERATIONS;
+        results.add(fftResult);
+
+        // the decibel conversion on its own, against the normalise and gainToDecibels passes it replaced.
+        // Both loops convert in place, so both pay for refreshing their input from the same magnitudes first.
+        int numBins = fftSize / 2;
+        std::vector<float> magnitudes((size_t)numBins), converted((size_t)numBins), referenceConverted((size_t)numBins);
+        for (int bin = 0; bin < numBins; ++bin) {
+            magnitudes[(size_t)bin] = std::abs(monoBuffer.getSample(0, bin)) * (float)numBins;
+        }
+
+        allocationsBefore = numAllocations;
+        start = BenchmarkClock::now();
+        for (int i = 0; i < ANALYZER_ITERATIONS; ++i) {
+            std::copy(magnitudes.begin(), magnitudes.end(), converted.begin());
+            convertMagnitudesToDecibels(converted.data(), numBins, 1.f / (float)numBins, ABSOLUTE_MINIMUM_GAIN);
+        }
+        nanoseconds = nanosecondsSince(start);
+        allocations = numAllocations - allocationsBefore;
+
+        referenceStart = BenchmarkClock::now();
+        for (int i = 0; i < ANALYZER_ITERATIONS; ++i) {
+            std::copy(magnitudes.begin(), magnitudes.end(), referenceConverted.begin());
+            for (int bin = 0; bin < numBins; ++bin) {
+                referenceConverted[(size_t)bin] /= (float)numBins;
+            }
+            for (int bin = 0; bin < numBins; ++bin) {
+                referenceConverted[(size_t)bin] = juce::Decibels::gainToDecibels(referenceConverted[(size_t)bin], ABSOLUTE_MINIMUM_GAIN);
+            }
+        }
+        referenceNanoseconds = nanosecondsSince(referenceStart);
+
+        maxErrorDb = 0.f;
+        for (int bin = 0; bin < numBins; ++bin) {
+            maxErrorDb = juce::jmax(maxErrorDb, std::abs(converted[(size_t)bin] - referenceConverted[(size_t)bin]));
+        }
+
+        BenchmarkResult decibelResult;
+        decibelResult.name = "convertMagnitudesToDecibels";
+        decibelResult.settings.set("fftSize", fftSize);
+        decibelResult.settings.set("simdLanes", (int)SIMDFloat::SIMDNumElements);
+        decibelResult.settings.set("referenceNsPerCall", referenceNanoseconds / ANALYZER_ITERATIONS);
+        decibelResult.settings.set("speedupOverReference", nanoseconds > 0.0 ? referenceNanoseconds / nanoseconds : 0.0);
+        decibelResult.settings.set("maxErrorDb", maxErrorDb);
+        decibelResult.nanosecondsPerCall = nanoseconds / ANALYZER_ITERATIONS;
+        decibelResult.nanosecondsPerSample = decibelResult.nanosecondsPerCall / numBins;
+        decibelResult.allocationsPerCall = (double)allocations / ANALYZER_ITERATIONS;
+        results.add(decibelResult);
+
+        AnalyzerPathGenerator<juce::Path> pathGenerator;
+        juce::Path path;
+        float binWidth = (float)(BENCHMARK_SAMPLE_RATE / fftSize);
+
+        allocationsBefore = numAllocations;
+        start = BenchmarkClock::now();
+        for (int i = 0; i < ANALYZER_ITERATIONS; ++i) {
+            pathGenerator.generatePath(fftData, fftBounds, fftSize, binWidth, ABSOLUTE_MINIMUM_GAIN);
+            pathGenerator.getPath(path);
+        }
+        nanoseconds = nanosecondsSince(start);
+        allocations = numAllocations - allocationsBefore;
+
+        BenchmarkResult pathResult;
+        pathResult.name = "AnalyzerPathGenerator::generatePath";
+        pathResult.settings.set("fftSize", fftSize);
+        pathResult.nanosecondsPerCall = nanoseconds / ANALYZER_ITERATIONS;
+        pathResult.nanosecondsPerSample = pathResult.nanosecondsPerCall / (fftSize / 2);
+        pathResult.allocationsPerCall = (double)allocations / ANALYZER_ITERATIONS;
+        results.add(pathResult);
+    }
+}
+
+// The response curve as paint used to compute it: the bands designed by juce::dsp::FilterDesign and IIR::Coefficients,
+// then one getMagnitudeForFrequency per filter per pixel column. Kept as the baseline the batch FrequencyResponseEvaluator is compared against.
+using ReferenceCoefficients = juce::dsp::IIR::Coefficients<float>;
+
+juce::ReferenceCountedArray<ReferenceCoefficients> makeReferenceFilters(const ChainSettings& chainSettings, double sampleRate) {
+    juce::ReferenceCountedArray<ReferenceCoefficients> filters =
+        juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq, sampleRate, 2 * (chainSettings.lowCutSlope + 1));
+    filters.add(ReferenceCoefficients::makePeakFilter(sampleRate,
+                                                      chainSettings.peakFreq,
+                                                      chainSettings.peakQuality,
+                                                      juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels)));
+    filters.addArray(juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq, sampleRate, 2 * (chainSettings.highCutSlope + 1)));
+    return filters;
+}
+
+void referenceResponseCurveMagnitudes(const juce::ReferenceCountedArray<ReferenceCoefficients>& filters, double sampleRate, std::vector<double>& magnitudes) {
+    int width = (int)magnitudes.size();
+    for (int i = 0; i < width; ++i) {
+        double magnitude = 1.f;
+        double freq = juce::mapToLog10(double(i) / double(width), 20.0, 20000.0);
+        for (ReferenceCoefficients* filter : filters) {
+            magnitude *= filter->getMagnitudeForFrequency(freq, sampleRate);
+        }
+        magnitudes[i] = juce::Decibels::gainToDecibels(magnitude);
+    }
+}
+
+//==============================================================================
+// The response curve for every stage of both cuts plus the peak, old per filter evaluation against the batch evaluator
+// running on the processor's own designs
+void benchmarkResponseCurve(juce::Array<BenchmarkResult>& results) {
+    ChainSettings chainSettings;
+    chainSettings.lowCutFreq = 100.f;
+    chainSettings.highCutFreq = 8000.f;
+    chainSettings.peakFreq = 1000.f;
+    chainSettings.peakGainInDecibels = 6.f;
+    chainSettings.peakQuality = 1.f;
+    chainSettings.lowCutSlope = Slope_48;
+    chainSettings.highCutSlope = Slope_48;
+
+    juce::ReferenceCountedArray<ReferenceCoefficients> referenceFilters = makeReferenceFilters(chainSettings, BENCHMARK_SAMPLE_RATE);
+
+    ChainCoefficients chainCoefficients;
+    designLowCut(chainCoefficients, chainSettings, BENCHMARK_SAMPLE_RATE);
+    designPeak(chainCoefficients, chainSettings, BENCHMARK_SAMPLE_RATE);
+    designHighCut(chainCoefficients, chainSettings, BENCHMARK_SAMPLE_RATE);
+    chainCoefficients.settings = chainSettings;
+
+    std::vector<double> referenceMagnitudes((size_t)RESPONSE_CURVE_WIDTH);
+
+    juce::int64 allocationsBefore = numAllocations;
+    BenchmarkClock::time_point start = BenchmarkClock::now();
+    for (int i = 0; i < RESPONSE_CURVE_ITERATIONS; ++i) {
+        referenceResponseCurveMagnitudes(referenceFilters, BENCHMARK_SAMPLE_RATE, referenceMagnitudes);
+    }
+    double referenceNanoseconds = nanosecondsSince(start);
+    juce::int64 referenceAllocations = numAllocations - allocationsBefore;
+
+    FrequencyResponseEvaluator evaluator;
+    evaluator.setLogFrequencies(RESPONSE_CURVE_WIDTH, FILTER_MIN_HZ, FILTER_MAX_HZ, BENCHMARK_SAMPLE_RATE);
+    std::vector<double> magnitudes((size_t)RESPONSE_CURVE_WIDTH);
+    std::vector<double> phases((size_t)RESPONSE_CURVE_WIDTH);
+
+    // gathering the stages is part of every editor update, so it is timed too
+    allocationsBefore = numAllocations;
+    start = BenchmarkClock::now();
+    for (int i = 0; i < RESPONSE_CURVE_ITERATIONS; ++i) {
+        FrequencyResponseEvaluator::StageArray stages;
+        int numStages = FrequencyResponseEvaluator::collectStages(chainCoefficients, stages);
+        evaluator.evaluate(stages.data(), numStages, magnitudes.data(), phases.data());
+    }
+    double nanoseconds = nanosecondsSince(start);
+    juce::int64 allocations = numAllocations - allocationsBefore;
+
+    double maxErrorDb = 0.0;
+    for (size_t i = 0; i < magnitudes.size(); ++i) {
+        maxErrorDb = juce::jmax(maxErrorDb, std::abs(magnitudes[i] - referenceMagnitudes[i]));
+    }
+
+    BenchmarkResult referenceResult;
+    referenceResult.name = "IIR::Coefficients::getMagnitudeForFrequency per filter";
+    referenceResult.settings.set("width", RESPONSE_CURVE_WIDTH);
+    referenceResult.nanosecondsPerCall = referenceNanoseconds / RESPONSE_CURVE_ITERATIONS;
+    // one "sample" is one pixel column here
+    referenceResult.nanosecondsPerSample = referenceResult.nanosecondsPerCall / RESPONSE_CURVE_WIDTH;
+    referenceResult.allocationsPerCall = (double)referenceAllocations / RESPONSE_CURVE_ITERATIONS;
+    results.add(referenceResult);
+
+    BenchmarkResult result;
+    result.name = "FrequencyResponseEvaluator::evaluate";
+    result.settings.set("width", RESPONSE_CURVE_WIDTH);
+    result.settings.set("withPhase", true);
+    result.settings.set("maxErrorDb", maxErrorDb);
+    result.nanosecondsPerCall = nanoseconds / RESPONSE_CURVE_ITERATIONS;
+    result.nanosecondsPerSample = result.nanosecondsPerCall / RESPONSE_CURVE_WIDTH;
+    result.allocationsPerCall = (double)allocations / RESPONSE_CURVE_ITERATIONS;
+    results.add(result);
+}
+
+//==============================================================================
+// The bands benchmarkFilterDesigns measures one at a time
+enum DesignBand {
+    LowCutBand,
+    PeakBand,
+    HighCutBand
+};
+
+// Magnitude in dB of the analog prototype each band is designed from, the whole band at its slope for the cuts
+double prototypeMagnitudeDb(const ChainSettings& chainSettings, DesignBand band, double frequency) {
+    // s normalised to each section's centre, so every section is (s^2 or 1 or s^2 + s * numeratorDamping + 1) / (s^2 + s / Q + 1)
+    std::complex<double> response(1.0, 0.0);
+    auto addSection = [&response, frequency](double centre, double numeratorDamping, double denominatorDamping, bool highPass, bool lowPass) {
+        std::complex<double> s(0.0, frequency / centre);
+        std::complex<double> numerator = highPass ? s * s : lowPass ? std::complex<double>(1.0, 0.0) : s * s + s * numeratorDamping + 1.0;
+        response *= numerator / (s * s + s * denominatorDamping + 1.0);
+    };
+
+    if (band == PeakBand) {
+        double A = std::sqrt(juce::Decibels::decibelsToGain((double)chainSettings.peakGainInDecibels));
+        double Q = chainSettings.peakQuality;
+        addSection(chainSettings.peakFreq, A / Q, 1.0 / (A * Q), false, false);
+    }
+    else {
+        bool isLowCut = band == LowCutBand;
+        int order = 2 * ((isLowCut ? chainSettings.lowCutSlope : chainSettings.highCutSlope) + 1);
+        for (int i = 0; i < order / 2; ++i) {
+            double Q = getButterworthQ(order, i);
+            addSection(isLowCut ? chainSettings.lowCutFreq : chainSettings.highCutFreq, 0.0, 1.0 / Q, isLowCut, !isLowCut);
+        }
+    }
+    return juce::Decibels::gainToDecibels(std::abs(response), -300.0);
+}
+
+// Each design's worst error against the analog prototype between 20Hz and 20KHz, the bell and cuts set close to
+// Nyquist where the bilinear transform cramps them. Cut errors are only counted down to -24dB, the bottom of the
+// response curve, past which the cut is doing its job whatever the exact level is. Each result also gives the design cost.
+// The processBlock cases show the matched designs run at the same cost, they only change the coefficients.
+void benchmarkFilterDesigns(juce::Array<BenchmarkResult>& results) {
+    const juce::StringArray bandNames{ "LowCut", "Peak", "HighCut" };
+    const int designIterations = 10000;
+
+    for (double sampleRate : { 44100.0, 48000.0 }) {
+        FrequencyResponseEvaluator evaluator;
+        evaluator.setLogFrequencies(RESPONSE_CURVE_WIDTH, FILTER_MIN_HZ, FILTER_MAX_HZ, sampleRate);
+        std::vector<double> magnitudes((size_t)RESPONSE_CURVE_WIDTH);
+
+        for (DesignBand band : { LowCutBand, PeakBand, HighCutBand }) {
+            for (float frequency : { 1000.f, 5000.f, 10000.f, 16000.f }) {
+                for (FilterDesign design : { Design_Bilinear, Design_Matched }) {
+                    ChainSettings chainSettings;
+                    chainSettings.lowCutBypassed = band != LowCutBand;
+                    chainSettings.peakBypassed = band != PeakBand;
+                    chainSettings.highCutBypassed = band != HighCutBand;
+                    chainSettings.lowCutFreq = frequency;
+                    chainSettings.peakFreq = frequency;
+                    chainSettings.highCutFreq = frequency;
+                    chainSettings.peakGainInDecibels = 12.f;
+                    chainSettings.peakQuality = 1.f;
+                    chainSettings.lowCutSlope = Slope_24;
+                    chainSettings.highCutSlope = Slope_24;
+                    chainSettings.lowCutDesign = design;
+                    chainSettings.peakDesign = design;
+                    chainSettings.highCutDesign = design;
+
+                    ChainCoefficients chainCoefficients;
+                    chainCoefficients.settings = chainSettings;
+                    juce::int64 allocationsBefore = numAllocations;
+                    BenchmarkClock::time_point start = BenchmarkClock::now();
+                    for (int i = 0; i < designIterations; ++i) {
+                        if (band == LowCutBand) {
+                            designLowCut(chainCoefficients, chainSettings, sampleRate);
+                        }
+                        else if (band == PeakBand) {
+                            designPeak(chainCoefficients, chainSettings, sampleRate);
+                        }
+                        else {
+                            designHighCut(chainCoefficients, chainSettings, sampleRate);
+                        }
+                    }
+                    double nanoseconds = nanosecondsSince(start);
+                    juce::int64 allocations = numAllocations - allocationsBefore;
+
+                    FrequencyResponseEvaluator::StageArray stages;
+                    int numStages = FrequencyResponseEvaluator::collectStages(chainCoefficients, stages);
+                    evaluator.evaluate(stages.data(), numStages, magnitudes.data());
+
+                    double maxErrorDb = 0.0;
+                    for (int i = 0; i < RESPONSE_CURVE_WIDTH; ++i) {
+                        double pointFrequency = juce::mapToLog10((double)i / (double)RESPONSE_CURVE_WIDTH, (double)FILTER_MIN_HZ, (double)FILTER_MAX_HZ);
+                        double prototypeDb = prototypeMagnitudeDb(chainSettings, band, pointFrequency);
+                        if (prototypeDb >= -24.0) {
+                            maxErrorDb = juce::jmax(maxErrorDb, std::abs(magnitudes[(size_t)i] - prototypeDb));
+                        }
+                    }
+
+                    BenchmarkResult result;
+                    result.name = "filter design";
+                    result.settings.set("sampleRate", sampleRate);
+                    result.settings.set("band", bandNames[(int)band]);
+                    result.settings.set("frequency", frequency);
+                    result.settings.set("design", FILTER_DESIGN_CHOICES[design]);
+                    result.settings.set("maxErrorDb", maxErrorDb);
+                    result.nanosecondsPerCall = nanoseconds / designIterations;
+                    // one "sample" is one designed band here
+                    result.nanosecondsPerSample = result.nanosecondsPerCall;
+                    result.allocationsPerCall = (double)allocations / designIterations;
+                    results.add(result);
+                }
+            }
+        }
+    }
+
+    const int blockSize = 512;
+    const int numCalls = PROCESS_SAMPLES_PER_CASE / blockSize;
+    juce::AudioBuffer<float> source(BENCHMARK_NUM_CHANNELS, blockSize);
+    fillWithNoise(source);
+    juce::AudioBuffer<float> buffer(BENCHMARK_NUM_CHANNELS, blockSize);
+    juce::MidiBuffer midi;
+
+    for (FilterDesign design : { Design_Bilinear, Design_Matched }) {
+        SimpleEQAudioProcessor processor;
+        setParameter(processor, LOW_CUT_FREQ_NAME, 100.f);
+        setParameter(processor, HIGH_CUT_FREQ_NAME, 16000.f);
+        setParameter(processor, PEAK_FREQ_NAME, 10000.f);
+        setParameter(processor, PEAK_GAIN_NAME, 6.f);
+        setParameter(processor, LOW_CUT_SLOPE_NAME, (float)Slope_48);
+        setParameter(processor, HIGH_CUT_SLOPE_NAME, (float)Slope_48);
+        setParameter(processor, LOW_CUT_DESIGN_NAME, (float)design);
+        setParameter(processor, PEAK_DESIGN_NAME, (float)design);
+        setParameter(processor, HIGH_CUT_DESIGN_NAME, (float)design);
+        processor.setRateAndBufferSizeDetails(BENCHMARK_SAMPLE_RATE, blockSize);
+        processor.prepareToPlay(BENCHMARK_SAMPLE_RATE, blockSize);
+
+        BenchmarkClock::time_point copyStart = BenchmarkClock::now();
+        for (int call = 0; call < numCalls; ++call) {
+            buffer.makeCopyOf(source, true);
+        }
+        double copyNanoseconds = nanosecondsSince(copyStart);
+
+        juce::int64 allocationsBefore = numAllocations;
+        BenchmarkClock::time_point start = BenchmarkClock::now();
+        for (int call = 0; call < numCalls; ++call) {
+            buffer.makeCopyOf(source, true);
+            processor.processBlock(buffer, midi);
+        }
+        double nanoseconds = juce::jmax(0.0, nanosecondsSince(start) - copyNanoseconds);
+        juce::int64 allocations = numAllocations - allocationsBefore;
+
+        processor.releaseResources();
+
+        BenchmarkResult result;
+        result.name = "processBlock (design)";
+        result.settings.set("blockSize", blockSize);
+        result.settings.set("design", FILTER_DESIGN_CHOICES[design]);
+        result.nanosecondsPerCall = nanoseconds / numCalls;
+        result.nanosecondsPerSample = nanoseconds / ((double)numCalls * blockSize);
+        result.allocationsPerCall = (double)allocations / numCalls;
+        results.add(result);
+    }
+}
+
+//==============================================================================
+// One step of the allocation check: what the host does to the parameters before the next block
+struct AllocationCheckStep {
+    juce::String description;
+    std::function<void(SimpleEQAudioProcessor&, int block)> change;
+};
+
+int runAllocationCheck() {
+    const int blockSize = 256;
+    const int blocksPerStep = 64; // long enough for every smoothing ramp to finish inside a step
+    juce::MidiBuffer midi;
+    juce::AudioBuffer<float> source(BENCHMARK_NUM_CHANNELS, blockSize);
+    fillWithNoise(source);
+    juce::AudioBuffer<float> buffer(BENCHMARK_NUM_CHANNELS, blockSize);
+
+    auto cycleChoice = [](const juce::String& name, int numChoices) {
+        return [name, numChoices](SimpleEQAudioProcessor& processor, int block) {
+            setParameter(processor, name, (float)(block % numChoices));
+        };
+    };
+
+    // the step's change runs before every one of its blocks, from the message thread's side of the processor
+    const std::vector<AllocationCheckStep> steps{
+        { "defaults", [](SimpleEQAudioProcessor&, int) {} },
+        { "frequency sweeps", [](SimpleEQAudioProcessor& processor, int block) {
+            float position = (float)block / blocksPerStep;
+            setParameter(processor, LOW_CUT_FREQ_NAME, juce::mapToLog10(position, FILTER_MIN_HZ, FILTER_MAX_HZ));
+            setParameter(processor, PEAK_FREQ_NAME, juce::mapToLog10(1.f - position, FILTER_MIN_HZ, FILTER_MAX_HZ));
+            setParameter(processor, HIGH_CUT_FREQ_NAME, juce::mapToLog10(position, FILTER_MIN_HZ, FILTER_MAX_HZ));
+        } },
+        { "gain and Q jumps", [](SimpleEQAudioProcessor& processor, int block) {
+            setParameter(processor, PEAK_GAIN_NAME, block % 2 == 0 ? PEAK_GAIN_MAX_DB : PEAK_GAIN_MIN_DB);
+            setParameter(processor, PEAK_QUALITY_NAME, block % 3 == 0 ? PEAK_QUALITY_MAX : PEAK_QUALITY_MIN);
+        } },
+        { "slopes", [](SimpleEQAudioProcessor& processor, int block) {
+            setParameter(processor, LOW_CUT_SLOPE_NAME, (float)(block % 4));
+            setParameter(processor, HIGH_CUT_SLOPE_NAME, (float)(3 - block % 4));
+        } },
+        { "bypass toggles", [](SimpleEQAudioProcessor& processor, int block) {
+            setParameter(processor, LOW_CUT_BYPASS_NAME, (float)(block & 1));
+            setParameter(processor, PEAK_BYPASS_NAME, (float)((block >> 1) & 1));
+            setParameter(processor, HIGH_CUT_BYPASS_NAME, (float)((block >> 2) & 1));
+        } },
+        { "low cut modes", cycleChoice(LOW_CUT_MODE_NAME, FILTER_MODE_CHOICES.size()) },
+        { "peak modes", cycleChoice(PEAK_MODE_NAME, FILTER_MODE_CHOICES.size()) },
+        { "high cut modes", cycleChoice(HIGH_CUT_MODE_NAME, FILTER_MODE_CHOICES.size()) },
+        { "designs", [](SimpleEQAudioProcessor& processor, int block) {
+            setParameter(processor, LOW_CUT_DESIGN_NAME, (float)(block % 2));
+            setParameter(processor, PEAK_DESIGN_NAME, (float)((block + 1) % 2));
+            setParameter(processor, HIGH_CUT_DESIGN_NAME, (float)(block % 2));
+        } },
+        { "modes while sweeping", [](SimpleEQAudioProcessor& processor, int block) {
+            setParameter(processor, PEAK_MODE_NAME, (float)(block % FILTER_MODE_CHOICES.size()));
+            setParameter(processor, PEAK_FREQ_NAME, block % 2 == 0 ? 200.f : 12000.f);
+            setParameter(processor, LOW_CUT_FREQ_NAME, block % 2 == 0 ? 40.f : 400.f);
+        } },
+    };
+
+    SimpleEQAudioProcessor processor;
+    processor.setRateAndBufferSizeDetails(BENCHMARK_SAMPLE_RATE, blockSize);
+    processor.prepareToPlay(BENCHMARK_SAMPLE_RATE, blockSize);
+    processor.addAnalyzerSubscriber();
+
+    int numFailures = 0;
+    for (bool silent : { false, true }) {
+        for (const AllocationCheckStep& step : steps) {
+            juce::int64 allocations = 0;
+            for (int block = 0; block < blocksPerStep; ++block) {
+                step.change(processor, block);
+                // design normally happens on the processor's timer, which has no message loop to run it here
+                processor.timerCallback();
+
+                if (silent) {
+                    buffer.clear();
+                }
+                else {
+                    buffer.makeCopyOf(source, true);
+                }
+
+                juce::int64 allocationsBefore = numAllocations;
+                processor.processBlock(buffer, midi);
+                allocations += numAllocations - allocationsBefore;
+            }
+
+            // the analyzer fifos are never read here, keep them from filling up
+            processor.leftChannelFifo.skipSamples(processor.leftChannelFifo.getNumSamplesAvailable());
+            processor.rightChannelFifo.skipSamples(processor.rightChannelFifo.getNumSamplesAvailable());
+
+            if (allocations > 0) {
+                std::cerr << "processBlock allocated " << allocations << " times during " << step.description
+                          << (silent ? " (silent input)" : "") << std::endl;
+                ++numFailures;
+            }
+        }
+    }
+
+    processor.removeAnalyzerSubscriber();
+    processor.releaseResources();
+
+    if (numFailures > 0) {
+        return 1;
+    }
+    std::cout << "processBlock made no allocations in " << 2 * steps.size() << " cases" << std::endl;
+    return 0;
+}
+
+//==============================================================================
+int runBenchmarks(const juce::File& jsonFile) {
+    juce::Array<BenchmarkResult> results;
+    benchmarkProcessBlock(results);
+    benchmarkNeutralProcessBlock(results);
+    benchmarkChannelCounts(results);
+    benchmarkFilterModes(results);
+    benchmarkAnalyzerTap(results);
+    benchmarkAnalyzer(results);
+    benchmarkResponseCurve(results);
+    benchmarkFilterDesigns(results);
+
+    juce::Array<juce::var> resultList;
+    for (const BenchmarkResult& result : results) {
+        resultList.add(result.toVar());
+    }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("sampleRate", BENCHMARK_SAMPLE_RATE);
+    report->setProperty("numChannels", BENCHMARK_NUM_CHANNELS);
+    report->setProperty("results", resultList);
+    juce::String json = juce::JSON::toString(juce::var(report));
+
+    std::cout << json << std::endl;
+
+    if (jsonFile != juce::File() && !jsonFile.replaceWithText(json)) {
+        std::cerr << "Could not write " << jsonFile.getFullPathName() << std::endl;
+        return 1;
+    }
+    return 0;
+}
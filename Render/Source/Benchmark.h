@@ -0,0 +1,25 @@
+/*
+  ==============================================================================
+
+    Benchmark.h
+    Created: 16 Oct 2026 4:12:30pm
+    Author:  Nate
+
+    Microbenchmarks for the audio and analyzer hot paths, run with
+    SimpleEQRender --benchmark.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Times processBlock over every block size, slope and bypass combination, then the analyzer tap,
+// FFT analysis, analyzer path generation and response curve magnitude loop. Results are printed as JSON and
+// written to jsonFile too when it is not empty. Returns the process exit code.
+int runBenchmarks(const juce::File& jsonFile);
+
+// Runs processBlock through parameter sweeps, smoothing, slope, bypass, mode and design switches, silence and the
+// analyzer tap, counting every heap allocation made inside processBlock. Returns 1 if any were made, 0 otherwise.
+int runAllocationCheck();
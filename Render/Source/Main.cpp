@@ -0,0 +1,374 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 16 Oct 2026 2:07:45pm
+    Author:  Nate
+
+    Headless offline renderer: streams audio files through SimpleEQAudioProcessor
+    with a saved plugin state, no editor and no audio device.
+    With --benchmark it runs the microbenchmarks in Benchmark.cpp instead, with
+    --check-allocations it checks processBlock never allocates, and with
+    --response it prints the EQ curve of a state for checking against a target.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <iostream>
+#include "../../Source/PluginProcessor.h"
+#include "Benchmark.h"
+#include "../../Source/FrequencyResponse.h"
+
+const int DEFAULT_RENDER_BLOCK_SIZE = 4096;
+const int DEFAULT_OUTPUT_BIT_DEPTH = 24;
+const double DEFAULT_RESPONSE_SAMPLE_RATE = 48000.0;
+
+// Everything the worker threads share. Each worker pulls the next file index until the list runs out.
+struct RenderJob {
+    juce::Array<juce::File> inputFiles;
+    juce::File outputDirectory;
+    juce::MemoryBlock state;
+    int blockSize = DEFAULT_RENDER_BLOCK_SIZE;
+    float flatBandTolerance = FLAT_BAND_TOLERANCE_DB;
+    double smoothingRampSeconds = SMOOTHING_RAMP_SECONDS;
+    int smoothingStrideSamples = SMOOTHING_STRIDE_SAMPLES;
+
+    std::atomic<int> nextFile{ 0 };
+    std::atomic<int> numFailed{ 0 };
+    std::atomic<juce::int64> numSamplesRendered{ 0 };
+
+    void log(const juce::String& message) {
+        const juce::ScopedLock lock(logLock);
+        std::cout << message << std::endl;
+    }
+
+private:
+    juce::CriticalSection logLock;
+};
+
+// One processor per worker, reused for every file that worker picks up
+struct RenderWorker : juce::Thread {
+    RenderWorker(RenderJob& j) : juce::Thread("SimpleEQ Render"), job(j) {
+        // created here on the main thread, the worker only ever uses it from run()
+        processor = std::make_unique<SimpleEQAudioProcessor>();
+        if (job.state.getSize() > 0) {
+            processor->setStateInformation(job.state.getData(), (int)job.state.getSize());
+        }
+        processor->setFlatBandTolerance(job.flatBandTolerance);
+        processor->setSmoothing(job.smoothingRampSeconds, job.smoothingStrideSamples);
+        formatManager.registerBasicFormats();
+    }
+
+    void run() override {
+        while (!threadShouldExit()) {
+            int index = job.nextFile.fetch_add(1);
+            if (index >= job.inputFiles.size()) {
+                return;
+            }
+
+            const juce::File& input = job.inputFiles.getReference(index);
+            juce::String error = renderFile(input);
+            if (error.isNotEmpty()) {
+                ++job.numFailed;
+                job.log("FAILED " + input.getFullPathName() + ": " + error);
+            }
+            else {
+                job.log("rendered " + input.getFullPathName() + " (" + processor->getRealtimeStats().toString() + ")");
+            }
+        }
+    }
+
+private:
+    RenderJob& job;
+    std::unique_ptr<SimpleEQAudioProcessor> processor;
+    juce::AudioFormatManager formatManager;
+
+    // Returns an empty string on success, otherwise what went wrong
+    juce::String renderFile(const juce::File& input) {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+        if (reader == nullptr) {
+            return "unsupported or unreadable audio file";
+        }
+
+        int numChannels = (int)reader->numChannels;
+        double sampleRate = reader->sampleRate;
+
+        // match the processor's buses to the file, isBusesLayoutSupported decides which channel counts we can handle
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+        layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+        if (!processor->setBusesLayout(layout)) {
+            return juce::String(numChannels) + " channel files are not supported";
+        }
+
+        juce::File output = job.outputDirectory.getChildFile(input.getFileName());
+        if (output == input) {
+            return "output would overwrite the input";
+        }
+
+        juce::AudioFormat* format = formatManager.findFormatForFileExtension(input.getFileExtension());
+        if (format == nullptr || (numChannels == 1 && !format->canDoMono()) || (numChannels == 2 && !format->canDoStereo())) {
+            return "no writer for " + input.getFileExtension();
+        }
+
+        int bitDepth = (int)reader->bitsPerSample;
+        if (!format->getPossibleBitDepths().contains(bitDepth)) {
+            bitDepth = DEFAULT_OUTPUT_BIT_DEPTH;
+        }
+
+        output.deleteFile();
+        std::unique_ptr<juce::FileOutputStream> outputStream = output.createOutputStream();
+        if (outputStream == nullptr) {
+            return "could not open " + output.getFullPathName();
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(outputStream.get(), sampleRate, (unsigned int)numChannels, bitDepth, reader->metadataValues, 0));
+        if (writer == nullptr) {
+            return "could not create a writer for " + output.getFullPathName();
+        }
+        outputStream.release(); // the writer owns the stream now
+
+        // offline: coefficients are designed inline in processBlock since there is no message loop running the timer
+        processor->setNonRealtime(true);
+        processor->setRateAndBufferSizeDetails(sampleRate, job.blockSize);
+        processor->prepareToPlay(sampleRate, job.blockSize);
+
+        juce::AudioBuffer<float> buffer(numChannels, job.blockSize);
+        juce::MidiBuffer midi;
+        juce::int64 length = reader->lengthInSamples;
+
+        for (juce::int64 position = 0; position < length; position += job.blockSize) {
+            int numSamples = (int)juce::jmin((juce::int64)job.blockSize, length - position);
+            buffer.setSize(numChannels, numSamples, false, false, true);
+            reader->read(&buffer, 0, numSamples, position, true, true);
+
+            processor->processBlock(buffer, midi);
+
+            if (!writer->writeFromAudioSampleBuffer(buffer, 0, numSamples)) {
+                processor->releaseResources();
+                return "write failed for " + output.getFullPathName();
+            }
+        }
+
+        // keep going on silence until the filters have rung out, so the end of the file isn't cut off.
+        // The tail is read after the input since it follows whatever the bands were last designed with.
+        juce::int64 tailLength = (juce::int64)std::ceil(processor->getTailLengthSeconds() * sampleRate);
+        for (juce::int64 position = 0; position < tailLength; position += job.blockSize) {
+            int numSamples = (int)juce::jmin((juce::int64)job.blockSize, tailLength - position);
+            buffer.setSize(numChannels, numSamples, false, false, true);
+            buffer.clear();
+
+            processor->processBlock(buffer, midi);
+
+            if (!writer->writeFromAudioSampleBuffer(buffer, 0, numSamples)) {
+                processor->releaseResources();
+                return "write failed for " + output.getFullPathName();
+            }
+        }
+
+        processor->releaseResources();
+        job.numSamplesRendered += length + tailLength;
+        return {};
+    }
+};
+
+// The state can be the binary blob from getStateInformation, or the same tree saved as XML
+juce::MemoryBlock loadState(const juce::File& file) {
+    juce::MemoryBlock block;
+    if (file.hasFileExtension("xml")) {
+        std::unique_ptr<juce::XmlElement> xml = juce::parseXML(file);
+        if (xml != nullptr) {
+            juce::MemoryOutputStream mos(block, false);
+            juce::ValueTree::fromXml(*xml).writeToStream(mos);
+        }
+    }
+    else {
+        file.loadFileAsData(block);
+    }
+    return block;
+}
+
+// Prints the combined magnitude (dB) and phase (radians) of every band at numPoints log spaced frequencies from 20Hz to 20KHz as JSON,
+// designed exactly the way the processor designs them
+int printResponse(const juce::MemoryBlock& state, int numPoints, double sampleRate, float flatBandTolerance) {
+    SimpleEQAudioProcessor processor;
+    if (state.getSize() > 0) {
+        processor.setStateInformation(state.getData(), (int)state.getSize());
+    }
+
+    ChainSettings chainSettings = getChainSettings(processor.apvts);
+    ChainCoefficients chainCoefficients;
+    designLowCut(chainCoefficients, chainSettings, sampleRate);
+    designPeak(chainCoefficients, chainSettings, sampleRate);
+    designHighCut(chainCoefficients, chainSettings, sampleRate);
+
+    FrequencyResponseEvaluator audibleBand;
+    audibleBand.setAudibleBand(sampleRate);
+    chainCoefficients.settings = bypassTransparentBands(findTransparentCuts(chainSettings, chainCoefficients, audibleBand, flatBandTolerance), flatBandTolerance);
+
+    FrequencyResponseEvaluator evaluator;
+    evaluator.setLogFrequencies(numPoints, FILTER_MIN_HZ, FILTER_MAX_HZ, sampleRate);
+    FrequencyResponseEvaluator::StageArray stages;
+    int numStages = FrequencyResponseEvaluator::collectStages(chainCoefficients, stages);
+
+    std::vector<double> magnitudes((size_t)numPoints), phases((size_t)numPoints);
+    evaluator.evaluate(stages.data(), numStages, magnitudes.data(), phases.data());
+
+    juce::Array<juce::var> points;
+    for (int i = 0; i < numPoints; ++i) {
+        auto* point = new juce::DynamicObject();
+        point->setProperty("frequency", juce::mapToLog10((double)i / (double)numPoints, (double)FILTER_MIN_HZ, (double)FILTER_MAX_HZ));
+        point->setProperty("magnitudeDb", magnitudes[(size_t)i]);
+        point->setProperty("phase", phases[(size_t)i]);
+        points.add(juce::var(point));
+    }
+
+    auto* response = new juce::DynamicObject();
+    response->setProperty("sampleRate", sampleRate);
+    response->setProperty("points", points);
+    std::cout << juce::JSON::toString(juce::var(response)) << std::endl;
+    return 0;
+}
+
+void printUsage() {
+    std::cout << "Usage: SimpleEQRender --output <dir> [--state <state.xml|state.bin>] [--jobs <n>] [--block-size <n>] [--flat-tolerance <dB>]" << std::endl
+              << "                      [--smoothing-ramp <seconds>] [--smoothing-stride <n>] <input files...>" << std::endl
+              << "  Renders each WAV/FLAC/AIFF input through SimpleEQ into <dir>, keeping its file name, format and bit depth." << std::endl
+              << "  --jobs defaults to the number of CPU cores, --block-size to " << DEFAULT_RENDER_BLOCK_SIZE << " samples." << std::endl
+              << "  --flat-tolerance is how close to 0dB a band's response has to stay to be left out, " << FLAT_BAND_TOLERANCE_DB << "dB by default, negative keeps every band." << std::endl
+              << "  --smoothing-ramp is how long parameter changes glide for, " << SMOOTHING_RAMP_SECONDS << "s by default, and --smoothing-stride" << std::endl
+              << "  how many samples go by between redesigns while they do, " << SMOOTHING_STRIDE_SAMPLES << " by default." << std::endl
+              << "       SimpleEQRender --benchmark [--json <results.json>]" << std::endl
+              << "  Times processBlock and the analyzer hot paths, printing ns/sample and allocations per call as JSON." << std::endl
+              << "       SimpleEQRender --check-allocations" << std::endl
+              << "  Drives processBlock through parameter, smoothing, mode and design changes and exits with 1 if it ever allocates." << std::endl
+              << "       SimpleEQRender --response <points> [--state <state.xml|state.bin>] [--sample-rate <hz>] [--flat-tolerance <dB>]" << std::endl
+              << "  Prints the magnitude and phase of the EQ curve at <points> log spaced frequencies as JSON." << std::endl;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // the processor's timer and parameters expect a message manager to exist, even though we never run its loop
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    RenderJob job;
+    juce::File stateFile;
+    juce::File jsonFile;
+    bool benchmark = false;
+    bool checkAllocations = false;
+    int numResponsePoints = 0;
+    double responseSampleRate = DEFAULT_RESPONSE_SAMPLE_RATE;
+    int numJobs = juce::SystemStats::getNumCpus();
+
+    for (int i = 1; i < argc; ++i) {
+        juce::String arg(argv[i]);
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        else if (arg == "--benchmark") {
+            benchmark = true;
+        }
+        else if (arg == "--check-allocations") {
+            checkAllocations = true;
+        }
+        else if (arg == "--response" && hasValue) {
+            numResponsePoints = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        }
+        else if (arg == "--sample-rate" && hasValue) {
+            responseSampleRate = juce::String(argv[++i]).getDoubleValue();
+        }
+        else if (arg == "--json" && hasValue) {
+            jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        }
+        else if (arg == "--output" && hasValue) {
+            job.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        }
+        else if (arg == "--state" && hasValue) {
+            stateFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        }
+        else if (arg == "--jobs" && hasValue) {
+            numJobs = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        }
+        else if (arg == "--block-size" && hasValue) {
+            job.blockSize = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        }
+        else if (arg == "--flat-tolerance" && hasValue) {
+            job.flatBandTolerance = juce::String(argv[++i]).getFloatValue();
+        }
+        else if (arg == "--smoothing-ramp" && hasValue) {
+            job.smoothingRampSeconds = juce::jmax(0.0, juce::String(argv[++i]).getDoubleValue());
+        }
+        else if (arg == "--smoothing-stride" && hasValue) {
+            job.smoothingStrideSamples = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        }
+        else if (arg.startsWith("--")) {
+            std::cerr << "Unknown or incomplete option " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        else {
+            job.inputFiles.add(juce::File::getCurrentWorkingDirectory().getChildFile(arg));
+        }
+    }
+
+    if (benchmark) {
+        return runBenchmarks(jsonFile);
+    }
+    if (checkAllocations) {
+        return runAllocationCheck();
+    }
+
+    if (stateFile != juce::File()) {
+        job.state = loadState(stateFile);
+        if (job.state.getSize() == 0) {
+            std::cerr << "Could not load a state from " << stateFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    if (numResponsePoints > 0) {
+        if (responseSampleRate <= 0.0) {
+            std::cerr << "--sample-rate must be positive" << std::endl;
+            return 1;
+        }
+        return printResponse(job.state, numResponsePoints, responseSampleRate, job.flatBandTolerance);
+    }
+
+    if (job.outputDirectory == juce::File() || job.inputFiles.isEmpty()) {
+        printUsage();
+        return 1;
+    }
+
+    if (!job.outputDirectory.createDirectory()) {
+        std::cerr << "Could not create " << job.outputDirectory.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    numJobs = juce::jmin(numJobs, job.inputFiles.size());
+    juce::OwnedArray<RenderWorker> workers;
+    for (int i = 0; i < numJobs; ++i) {
+        workers.add(new RenderWorker(job));
+    }
+
+    double startTime = juce::Time::getMillisecondCounterHiRes();
+    for (RenderWorker* worker : workers) {
+        worker->startThread();
+    }
+    for (RenderWorker* worker : workers) {
+        worker->waitForThreadToExit(-1);
+    }
+    double seconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+    int numFiles = job.inputFiles.size();
+    int numFailed = job.numFailed.load();
+    std::cout << (numFiles - numFailed) << "/" << numFiles << " files, "
+              << job.numSamplesRendered.load() << " sample frames in " << seconds << "s using " << numJobs << " threads" << std::endl;
+
+    return numFailed == 0 ? 0 : 1;
+}
@@ -16,20 +16,28 @@
 const juce::String LOW_CUT_FREQ_NAME = "LowCut Freq";
 const juce::String LOW_CUT_SLOPE_NAME = "LowCut Slope";
 const juce::String LOW_CUT_BYPASS_NAME = "LowCut Bypassed";
+const juce::String LOW_CUT_MODE_NAME = "LowCut Mode";
+const juce::String LOW_CUT_DESIGN_NAME = "LowCut Design";
 
 // HighCut Filter
 const juce::String HIGH_CUT_FREQ_NAME = "HighCut Freq";
 const juce::String HIGH_CUT_SLOPE_NAME = "HighCut Slope";
 const juce::String HIGH_CUT_BYPASS_NAME = "HighCut Bypassed";
+const juce::String HIGH_CUT_MODE_NAME = "HighCut Mode";
+const juce::String HIGH_CUT_DESIGN_NAME = "HighCut Design";
 
 // Peak Filter
 const juce::String PEAK_FREQ_NAME = "Peak Freq";
 const juce::String PEAK_GAIN_NAME = "Peak Gain";
 const juce::String PEAK_QUALITY_NAME = "Peak Quality";
 const juce::String PEAK_BYPASS_NAME = "Peak Bypassed";
+const juce::String PEAK_MODE_NAME = "Peak Mode";
+const juce::String PEAK_DESIGN_NAME = "Peak Design";
 
 // Analyzer
 const juce::String ANALYZER_ENABLED_NAME = "Analyzer Enabled";
+const juce::String ANALYZER_OVERLAP_NAME = "Analyzer Overlap";
+const juce::String ANALYZER_LATEST_FRAME_ONLY_NAME = "Analyzer Latest Frame Only";
 
 
 //==============================================================================
@@ -66,11 +74,36 @@ const float FILTER_FREQUENCY_SKEW_FACTOR = 0.25f;
 const float DEFAULT_SKEW_FACTOR = 1.f;
 
 const int SLOPE_DEFAULT_POS = 0;
+const int MODE_DEFAULT_POS = 0; // Float TDF-II
+const int DESIGN_DEFAULT_POS = 0; // Bilinear
 const bool BYPASS_DEFAULT = false;
 const bool ENABLED_DEFAULT = true;
+const int ANALYZER_OVERLAP_DEFAULT_POS = 3; // 87.5%, a 1024 sample hop on the 8192 point FFT, about 47 frames per second at 48KHz
+const bool ANALYZER_LATEST_FRAME_ONLY_DEFAULT = true;
 
 const float ABSOLUTE_MINIMUM_GAIN = -48.f; // Scale only goes to -48dB
 
+const int CUT_FILTER_STAGES = 4; // Each cut filter is up to 4 chained 12dB/Oct biquads for a 48dB/Oct slope
+const int CASCADE_STAGES = CUT_FILTER_STAGES + 1 + CUT_FILTER_STAGES; // low cut, peak, high cut
+const int MAX_PROCESS_CHANNELS = 16; // Widest bus one instance can EQ, enough for 7.1.4 (12) and 9.1.6 (16)
+
+const int COEFFICIENT_UPDATE_RATE_HZ = 100; // How often the message thread checks for parameter changes and redesigns the filters
+
+const int ANALYZER_RING_MIN_SAMPLES = 1 << 15; // Samples each analyzer channel can buffer between editor ticks, at least an 8192 point FFT window
+
+const int ANALYZER_THREAD_INTERVAL_MS = 15; // How long the shared analyzer thread sleeps between passes over every open analyzer, roughly 60 frames per second
+const int ANALYZER_THREAD_STOP_TIMEOUT_MS = 1000;
+
+const double SMOOTHING_RAMP_SECONDS = 0.05; // Default for how long frequency, gain and Q take to glide to a new value
+const int SMOOTHING_STRIDE_SAMPLES = 32; // Default for how many samples go by between redesigns while gliding
+
+const float SILENCE_THRESHOLD_DB = -120.f; // Input blocks and filter state quieter than this count as silent
+const double TAIL_DECAY_DB = -120.0; // The reported tail is how long the filters ring before falling this far
+const double MAX_TAIL_SECONDS = 10.0; // Cap for sections whose poles sit on or too close to the unit circle
+
+const float FLAT_BAND_TOLERANCE_DB = 0.01f; // A band whose response stays this close to 0dB is dropped from the cascade, well under the 0.5dB gain step
+const int TRANSPARENCY_CHECK_POINTS = 64; // Log spaced frequencies across the audible band a cut's response is checked at before it's dropped
+
 
 //==============================================================================
 // Units
@@ -79,6 +112,15 @@ const juce::String KILO_HZ = "KHz";
 const juce::String DB = "dB";
 const juce::String DB_PER_OCT = "db/Oct";
 
+// Analyzer overlap between consecutive FFT windows, each step halves the hop size
+const juce::StringArray ANALYZER_OVERLAP_CHOICES{ "0%", "50%", "75%", "87.5%" };
+
+// Filter modes, in the same order as the FilterMode enum
+const juce::StringArray FILTER_MODE_CHOICES{ "Float TDF-II", "Double TDF-II", "Float SVF" };
+
+// Filter designs, in the same order as the FilterDesign enum
+const juce::StringArray FILTER_DESIGN_CHOICES{ "Bilinear", "Matched" };
+
 
 //==============================================================================
 // UI Values
@@ -99,6 +141,9 @@ const int ANALYSIS_AREA_PADDING = 4;
 const int SLIDER_X_PADDING = 2;
 
 const int NUMBER_OF_LINES_TEXT = 1;
+const int DSP_LOAD_FONT_HEIGHT = 10;
+const int DSP_LOAD_REFRESH_MS = 500; // The load readout has a slow timer of its own, so it doesn't keep the frame timer running
+const int EDITOR_FRAME_INTERVAL_MS = 16; // ~60Hz, only while the analyzer is on or the curve needs rebuilding
 
 const float ELLIPSE_DEFAULT_THICKNESS = 1.f;
 const float ELLIPSE_THICKER_OUTLINE = 2.f;
@@ -0,0 +1,437 @@
+/*
+  ==============================================================================
+
+    FilterCascade.h
+    Created: 16 Oct 2026 9:41:12am
+    Author:  Nate
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <type_traits>
+#include "Constants.h"
+
+// Normalised (a0 == 1) second order section, in the same order juce::dsp::IIR::Coefficients stores them
+template<typename NumericType>
+struct BiquadCoefficients {
+    NumericType b0{ 1 }, b1{ 0 }, b2{ 0 }, a1{ 0 }, a2{ 0 };
+
+    template<typename OtherType>
+    BiquadCoefficients<OtherType> convertedTo() const {
+        return { (OtherType)b0, (OtherType)b1, (OtherType)b2, (OtherType)a1, (OtherType)a2 };
+    }
+};
+
+// Andrew Simper's linear trapezoidal state variable filter. a1-a3 come from the cutoff and damping,
+// m0-m2 mix the input, band and low outputs to give the same response as the equivalent biquad.
+struct SVFCoefficients {
+    float a1{ 1.f }, a2{ 0.f }, a3{ 0.f };
+    float m0{ 1.f }, m1{ 0.f }, m2{ 0.f };
+};
+
+// One designed second order section, in every form the cascade knows how to run it
+struct CascadeSection {
+    BiquadCoefficients<double> biquad;
+    SVFCoefficients svf;
+};
+
+// Precision/topology each band can be run with.
+// Float TDF-II is the cheapest, double TDF-II avoids coefficient quantization on very low cuts at high sample rates,
+// and the SVF keeps its state well scaled at low frequencies while staying in float.
+enum FilterMode {
+    Mode_FloatTDF2,
+    Mode_DoubleTDF2,
+    Mode_FloatSVF
+};
+
+using SIMDFloat = juce::dsp::SIMDRegister<float>;
+using SIMDDouble = juce::dsp::SIMDRegister<double>;
+
+// Runs every biquad of the EQ (low cut sections, peak, high cut sections) for all channels at once.
+// The channels are interleaved into the lanes of a SIMD register, so left and right are filtered by the same instructions
+// instead of by a separate filter for each channel. Buses wider than one register are worked through a group of lanes at a time,
+// every group sharing the one set of coefficients and keeping its own state.
+class FilterCascade {
+public:
+    static constexpr int NumLanes = (int)SIMDFloat::SIMDNumElements;
+    static constexpr int MaxGroups = (MAX_PROCESS_CHANNELS + NumLanes - 1) / NumLanes;
+    static constexpr int MaxChannels = MaxGroups * NumLanes;
+    // the double precision mode runs a group's lanes through as many double registers as it takes to hold them
+    static constexpr int DoubleLanes = (int)SIMDDouble::SIMDNumElements;
+    static constexpr int DoubleRegistersPerGroup = NumLanes / DoubleLanes;
+    static_assert(NumLanes % DoubleLanes == 0, "a group of float lanes has to split evenly into double registers");
+
+    // Allocates the interleaving scratch space, must be called before process() and never from the audio thread
+    void prepare(int maximumBlockSize) {
+        maxBlockSize = juce::jmax(1, maximumBlockSize);
+        // one extra register worth of space so the data can be moved onto a SIMD aligned address
+        interleaved.calloc((size_t)((maxBlockSize + 1) * NumLanes));
+        interleavedData = SIMDFloat::getNextSIMDAlignedPtr(interleaved.get());
+        reset();
+    }
+
+    void reset() {
+        for (Stage& stage : stages) {
+            resetState(stage);
+        }
+    }
+
+    //==============================================================================
+    // Setting coefficients never allocates, so these are safe to call from the audio thread
+    void setLowCut(const std::array<CascadeSection, CUT_FILTER_STAGES>& sections, int numCutStages, FilterMode mode) {
+        setCutStages(LowCutStart, sections, numCutStages, mode);
+    }
+
+    void setPeak(const CascadeSection& section, bool active, FilterMode mode) {
+        setStage(stages[PeakStart], section, active, mode);
+        updateActiveStages();
+    }
+
+    void setHighCut(const std::array<CascadeSection, CUT_FILTER_STAGES>& sections, int numCutStages, FilterMode mode) {
+        setCutStages(HighCutStart, sections, numCutStages, mode);
+    }
+
+    //==============================================================================
+    void process(float* const* channels, int numChannels, int numSamples) {
+        jassert(interleavedData != nullptr); // prepare() has not been called
+        jassert(numChannels <= MaxChannels);
+        numChannels = juce::jmin(numChannels, MaxChannels);
+        int numGroups = getNumGroups(numChannels);
+
+        if (numActiveStages == 0) {
+            return; // every band is bypassed, the buffer already holds the output
+        }
+
+        for (int group = 0; group < numGroups; ++group) {
+            float* const* groupChannels = channels + group * NumLanes;
+            int numGroupChannels = juce::jmin(NumLanes, numChannels - group * NumLanes);
+
+            // hosts are allowed to send more than the prepared block size, so work through it in chunks that fit the scratch space
+            for (int start = 0; start < numSamples; start += maxBlockSize) {
+                int chunkSize = juce::jmin(maxBlockSize, numSamples - start);
+
+                interleave(groupChannels, numGroupChannels, start, chunkSize);
+                for (int r = 0; r < numRuns; ++r) {
+                    processRun(runs[r], group, chunkSize);
+                }
+                deinterleave(groupChannels, numGroupChannels, start, chunkSize);
+            }
+        }
+    }
+
+    // Number of filter state values that are denormal, over the groups of lanes process() runs for numChannels.
+    // ScopedNoDenormals should keep this at zero, anything else means flush-to-zero isn't in effect and the feedback paths are running slow.
+    int countDenormalStates(int numChannels) const {
+        int numStateChannels = getNumGroups(numChannels) * NumLanes;
+        int count = 0;
+        for (int i = 0; i < numActiveStages; ++i) {
+            const Stage& stage = stages[activeStageIndices[i]];
+            for (int channel = 0; channel < numStateChannels; ++channel) {
+                const SIMDFloat& z1 = stage.z1[channel / NumLanes];
+                const SIMDFloat& z2 = stage.z2[channel / NumLanes];
+                size_t lane = (size_t)(channel % NumLanes);
+                count += isDenormal(z1.get(lane)) + isDenormal(z2.get(lane));
+                count += isDenormal(getDoubleState(stage.doubleZ1, channel)) + isDenormal(getDoubleState(stage.doubleZ2, channel));
+            }
+        }
+        return count;
+    }
+
+    // True when every state value of every active section, over the groups of lanes process() runs for numChannels,
+    // is smaller than threshold, i.e. with silence going in the cascade has nothing left to ring out
+    bool isStateBelow(float threshold, int numChannels) const {
+        int numStateChannels = getNumGroups(numChannels) * NumLanes;
+        for (int i = 0; i < numActiveStages; ++i) {
+            const Stage& stage = stages[activeStageIndices[i]];
+            for (int channel = 0; channel < numStateChannels; ++channel) {
+                const SIMDFloat& z1 = stage.z1[channel / NumLanes];
+                const SIMDFloat& z2 = stage.z2[channel / NumLanes];
+                size_t lane = (size_t)(channel % NumLanes);
+                if (std::abs(z1.get(lane)) >= threshold || std::abs(z2.get(lane)) >= threshold
+                    || std::abs(getDoubleState(stage.doubleZ1, channel)) >= threshold
+                    || std::abs(getDoubleState(stage.doubleZ2, channel)) >= threshold) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr int LowCutStart = 0;
+    static constexpr int PeakStart = CUT_FILTER_STAGES;
+    static constexpr int HighCutStart = CUT_FILTER_STAGES + 1;
+
+    struct Stage {
+        CascadeSection section;
+        BiquadCoefficients<float> coefficients; // float copy of section.biquad for the float kernels
+        FilterMode mode = Mode_FloatTDF2;
+        bool active = false;
+
+        // Transposed Direct Form II state (float), or the two integrator states (SVF), one register per group of channels
+        std::array<SIMDFloat, MaxGroups> z1, z2;
+        // Transposed Direct Form II state for the double precision mode, DoubleRegistersPerGroup registers per group of channels
+        std::array<SIMDDouble, MaxGroups * DoubleRegistersPerGroup> doubleZ1, doubleZ2;
+    };
+
+    // Neighbouring active stages that share a mode. Each run is fused into a single pass over the block,
+    // so switching one band to another mode only splits the cascade where the mode changes.
+    struct Run {
+        FilterMode mode = Mode_FloatTDF2;
+        int firstStage = 0; // into activeStageIndices
+        int numStages = 0;
+    };
+
+    std::array<Stage, CASCADE_STAGES> stages;
+
+    // Indices of just the active stages, packed together in cascade order, and the runs they split into.
+    // Rebuilt whenever a slope, bypass or mode changes, so the per sample loop never has to look at a bypass flag.
+    std::array<int, CASCADE_STAGES> activeStageIndices;
+    int numActiveStages = 0;
+    std::array<Run, CASCADE_STAGES> runs;
+    int numRuns = 0;
+
+    juce::HeapBlock<float> interleaved;
+    float* interleavedData = nullptr;
+    int maxBlockSize = 0;
+
+    // groups of lanes needed for numChannels, the same for process() and the state queries
+    static int getNumGroups(int numChannels) {
+        return (juce::jlimit(0, MaxChannels, numChannels) + NumLanes - 1) / NumLanes;
+    }
+
+    template<typename NumericType>
+    static int isDenormal(NumericType value) {
+        return std::fpclassify(value) == FP_SUBNORMAL ? 1 : 0;
+    }
+
+    static double getDoubleState(const std::array<SIMDDouble, MaxGroups * DoubleRegistersPerGroup>& state, int channel) {
+        return state[(size_t)(channel / DoubleLanes)].get((size_t)(channel % DoubleLanes));
+    }
+
+    static void resetState(Stage& stage) {
+        stage.z1.fill(SIMDFloat::expand(0.f));
+        stage.z2.fill(SIMDFloat::expand(0.f));
+        stage.doubleZ1.fill(SIMDDouble::expand(0.0));
+        stage.doubleZ2.fill(SIMDDouble::expand(0.0));
+    }
+
+    static void setStage(Stage& stage, const CascadeSection& section, bool active, FilterMode mode) {
+        // each mode keeps its state in a different form, so start a switched stage from silence rather than reinterpreting it.
+        // A stage coming back into the cascade starts from silence too, not from whatever it held when it dropped out.
+        if (mode != stage.mode || (active && !stage.active)) {
+            resetState(stage);
+        }
+
+        stage.section = section;
+        stage.coefficients = section.biquad.convertedTo<float>();
+        stage.mode = mode;
+        stage.active = active;
+    }
+
+    void setCutStages(int firstStage, const std::array<CascadeSection, CUT_FILTER_STAGES>& sections, int numCutStages, FilterMode mode) {
+        jassert(0 <= numCutStages && numCutStages <= CUT_FILTER_STAGES);
+        for (int i = 0; i < CUT_FILTER_STAGES; ++i) {
+            setStage(stages[firstStage + i], sections[i], i < numCutStages, mode);
+        }
+        updateActiveStages();
+    }
+
+    void updateActiveStages() {
+        numActiveStages = 0;
+        numRuns = 0;
+        for (int i = 0; i < CASCADE_STAGES; ++i) {
+            if (!stages[i].active) {
+                continue;
+            }
+            if (numRuns == 0 || runs[numRuns - 1].mode != stages[i].mode) {
+                runs[numRuns] = { stages[i].mode, numActiveStages, 0 };
+                ++numRuns;
+            }
+            ++runs[numRuns - 1].numStages;
+            activeStageIndices[numActiveStages] = i;
+            ++numActiveStages;
+        }
+    }
+
+    // Lane c of sample i lives at interleavedData[i * NumLanes + c]. The lanes past the last channel of a partly filled group
+    // are zeroed, so another group's samples left in the scratch space never get into this group's state.
+    void interleave(float* const* channels, int numChannels, int start, int numSamples) {
+        for (int c = 0; c < numChannels; ++c) {
+            const float* source = channels[c] + start;
+            for (int i = 0; i < numSamples; ++i) {
+                interleavedData[i * NumLanes + c] = source[i];
+            }
+        }
+        for (int c = numChannels; c < NumLanes; ++c) {
+            for (int i = 0; i < numSamples; ++i) {
+                interleavedData[i * NumLanes + c] = 0.f;
+            }
+        }
+    }
+
+    void deinterleave(float* const* channels, int numChannels, int start, int numSamples) {
+        for (int c = 0; c < numChannels; ++c) {
+            float* destination = channels[c] + start;
+            for (int i = 0; i < numSamples; ++i) {
+                destination[i] = interleavedData[i * NumLanes + c];
+            }
+        }
+    }
+
+    // Every slope and bypass combination packs down to runs of 1 to 9 active sections in cascade order,
+    // so picking the kernel instantiated for that many sections covers all of them
+    void processRun(const Run& run, int group, int numSamples) {
+        dispatchRunLength(run.numStages, [&](auto numStages) {
+            constexpr int NumStages = decltype(numStages)::value;
+            switch (run.mode)
+            {
+            case Mode_FloatTDF2:
+                processFloatTDF2Run<NumStages>(run.firstStage, group, numSamples);
+                break;
+            case Mode_DoubleTDF2:
+                processDoubleTDF2Run<NumStages>(run.firstStage, group, numSamples);
+                break;
+            case Mode_FloatSVF:
+                processSVFRun<NumStages>(run.firstStage, group, numSamples);
+                break;
+            }
+        });
+    }
+
+    template<typename Function>
+    static void dispatchRunLength(int numStages, Function&& function) {
+        switch (numStages)
+        {
+        case 1: function(std::integral_constant<int, 1>()); break;
+        case 2: function(std::integral_constant<int, 2>()); break;
+        case 3: function(std::integral_constant<int, 3>()); break;
+        case 4: function(std::integral_constant<int, 4>()); break;
+        case 5: function(std::integral_constant<int, 5>()); break;
+        case 6: function(std::integral_constant<int, 6>()); break;
+        case 7: function(std::integral_constant<int, 7>()); break;
+        case 8: function(std::integral_constant<int, 8>()); break;
+        case 9: function(std::integral_constant<int, 9>()); break;
+        default: jassertfalse; break;
+        }
+    }
+
+    // Every section of the run goes back to back on each frame, so the block is read and written once no matter how many
+    // sections the run has. The section count is a compile time constant and the coefficients and state are locals,
+    // so the compiler can fully unroll the run and keep it in registers with no bypass checks in the loop.
+    template<int NumStages>
+    void processFloatTDF2Run(int firstStage, int group, int numSamples) {
+        std::array<BiquadCoefficients<float>, NumStages> c;
+        std::array<SIMDFloat, NumStages> z1, z2;
+        for (int s = 0; s < NumStages; ++s) {
+            const Stage& stage = stages[activeStageIndices[firstStage + s]];
+            c[s] = stage.coefficients;
+            z1[s] = stage.z1[group];
+            z2[s] = stage.z2[group];
+        }
+
+        for (int i = 0; i < numSamples; ++i) {
+            float* frame = interleavedData + i * NumLanes;
+            SIMDFloat x = SIMDFloat::fromRawArray(frame);
+
+            for (int s = 0; s < NumStages; ++s) {
+                SIMDFloat y = x * c[s].b0 + z1[s];
+                z1[s] = x * c[s].b1 - y * c[s].a1 + z2[s];
+                z2[s] = x * c[s].b2 - y * c[s].a2;
+                x = y;
+            }
+
+            x.copyToRawArray(frame);
+        }
+
+        for (int s = 0; s < NumStages; ++s) {
+            Stage& stage = stages[activeStageIndices[firstStage + s]];
+            stage.z1[group] = z1[s];
+            stage.z2[group] = z2[s];
+        }
+    }
+
+    // Coefficients and state are both double here, and the samples stay in double between the sections of the run.
+    // Each frame is widened once into double registers and narrowed back to float once at the end of the run.
+    template<int NumStages>
+    void processDoubleTDF2Run(int firstStage, int group, int numSamples) {
+        std::array<BiquadCoefficients<double>, NumStages> c;
+        std::array<std::array<SIMDDouble, DoubleRegistersPerGroup>, NumStages> z1, z2;
+        for (int s = 0; s < NumStages; ++s) {
+            const Stage& stage = stages[activeStageIndices[firstStage + s]];
+            c[s] = stage.section.biquad;
+            for (int r = 0; r < DoubleRegistersPerGroup; ++r) {
+                z1[s][r] = stage.doubleZ1[group * DoubleRegistersPerGroup + r];
+                z2[s][r] = stage.doubleZ2[group * DoubleRegistersPerGroup + r];
+            }
+        }
+
+        alignas(SIMDDouble::SIMDRegisterSize) std::array<double, NumLanes> wide;
+        for (int i = 0; i < numSamples; ++i) {
+            float* frame = interleavedData + i * NumLanes;
+            for (int lane = 0; lane < NumLanes; ++lane) {
+                wide[lane] = frame[lane];
+            }
+
+            for (int r = 0; r < DoubleRegistersPerGroup; ++r) {
+                SIMDDouble x = SIMDDouble::fromRawArray(wide.data() + r * DoubleLanes);
+                for (int s = 0; s < NumStages; ++s) {
+                    SIMDDouble y = x * c[s].b0 + z1[s][r];
+                    z1[s][r] = x * c[s].b1 - y * c[s].a1 + z2[s][r];
+                    z2[s][r] = x * c[s].b2 - y * c[s].a2;
+                    x = y;
+                }
+                x.copyToRawArray(wide.data() + r * DoubleLanes);
+            }
+
+            for (int lane = 0; lane < NumLanes; ++lane) {
+                frame[lane] = (float)wide[lane];
+            }
+        }
+
+        for (int s = 0; s < NumStages; ++s) {
+            Stage& stage = stages[activeStageIndices[firstStage + s]];
+            for (int r = 0; r < DoubleRegistersPerGroup; ++r) {
+                stage.doubleZ1[group * DoubleRegistersPerGroup + r] = z1[s][r];
+                stage.doubleZ2[group * DoubleRegistersPerGroup + r] = z2[s][r];
+            }
+        }
+    }
+
+    template<int NumStages>
+    void processSVFRun(int firstStage, int group, int numSamples) {
+        std::array<SVFCoefficients, NumStages> c;
+        std::array<SIMDFloat, NumStages> ic1eq, ic2eq;
+        for (int s = 0; s < NumStages; ++s) {
+            const Stage& stage = stages[activeStageIndices[firstStage + s]];
+            c[s] = stage.section.svf;
+            ic1eq[s] = stage.z1[group];
+            ic2eq[s] = stage.z2[group];
+        }
+
+        for (int i = 0; i < numSamples; ++i) {
+            float* frame = interleavedData + i * NumLanes;
+            SIMDFloat x = SIMDFloat::fromRawArray(frame);
+
+            for (int s = 0; s < NumStages; ++s) {
+                SIMDFloat v3 = x - ic2eq[s];
+                SIMDFloat v1 = ic1eq[s] * c[s].a1 + v3 * c[s].a2;
+                SIMDFloat v2 = ic2eq[s] + ic1eq[s] * c[s].a2 + v3 * c[s].a3;
+                ic1eq[s] = v1 * 2.f - ic1eq[s];
+                ic2eq[s] = v2 * 2.f - ic2eq[s];
+                x = x * c[s].m0 + v1 * c[s].m1 + v2 * c[s].m2;
+            }
+
+            x.copyToRawArray(frame);
+        }
+
+        for (int s = 0; s < NumStages; ++s) {
+            Stage& stage = stages[activeStageIndices[firstStage + s]];
+            stage.z1[group] = ic1eq[s];
+            stage.z2[group] = ic2eq[s];
+        }
+    }
+};
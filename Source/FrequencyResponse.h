@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+    FrequencyResponse.h
+    Created: 16 Oct 2026 7:22:41pm
+    Author:  Nate
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "PluginProcessor.h"
+
+// Evaluates the combined response of a cascade of biquads at a whole grid of frequencies at once.
+// The sines and cosines of each frequency are worked out once in setFrequencies and shared by every stage and every
+// later evaluate(). The grid is held in SIMDRegister<double>s, so each stage is applied to a register's worth of
+// frequencies per instruction, rather than a complex polynomial per frequency per stage like IIR::Coefficients::getMagnitudeForFrequency.
+// The numerators and denominators are multiplied up separately, so the only division is one per frequency at the end.
+class FrequencyResponseEvaluator {
+public:
+    static constexpr int NumLanes = (int)SIMDDouble::SIMDNumElements;
+
+    // Allocates, so call it when the grid or sample rate changes rather than per evaluation
+    void setFrequencies(const double* frequencies, int numFrequencies, double sampleRate) {
+        numPoints = juce::jmax(0, numFrequencies);
+        numRegisters = (numPoints + NumLanes - 1) / NumLanes;
+        // the lanes past the last frequency are left at w = 0, where every term is finite, and never written out
+        for (std::vector<SIMDDouble>* v : { &cosW, &negativeSinW, &cos2W, &negativeSin2W }) {
+            v->assign((size_t)numRegisters, SIMDDouble::expand(0.0));
+        }
+        for (int r = 0; r < numRegisters; ++r) {
+            cosW[(size_t)r] = SIMDDouble::expand(1.0);
+            cos2W[(size_t)r] = SIMDDouble::expand(1.0);
+        }
+
+        for (int i = 0; i < numPoints; ++i) {
+            double w = juce::MathConstants<double>::twoPi * frequencies[i] / sampleRate;
+            double c = std::cos(w);
+            double s = std::sin(w);
+            size_t r = (size_t)(i / NumLanes);
+            size_t lane = (size_t)(i % NumLanes);
+            cosW[r].set(lane, c);
+            negativeSinW[r].set(lane, -s);
+            cos2W[r].set(lane, 2.0 * c * c - 1.0);
+            negativeSin2W[r].set(lane, -2.0 * s * c);
+        }
+    }
+
+    // Log spaced between minFrequency and maxFrequency, the same spacing as the response curve's pixel columns
+    void setLogFrequencies(int numFrequencies, double minFrequency, double maxFrequency, double sampleRate) {
+        std::vector<double> frequencies((size_t)juce::jmax(0, numFrequencies));
+        for (int i = 0; i < numFrequencies; ++i) {
+            frequencies[(size_t)i] = juce::mapToLog10((double)i / (double)numFrequencies, minFrequency, maxFrequency);
+        }
+        setFrequencies(frequencies.data(), numFrequencies, sampleRate);
+    }
+
+    // The grid bypassTransparentBands checks the cuts over, FILTER_MIN_HZ up to FILTER_MAX_HZ or Nyquist, both ends included
+    void setAudibleBand(double sampleRate) {
+        double maxFrequency = juce::jmin((double)FILTER_MAX_HZ, 0.5 * sampleRate);
+        std::vector<double> frequencies((size_t)TRANSPARENCY_CHECK_POINTS);
+        for (int i = 0; i < TRANSPARENCY_CHECK_POINTS; ++i) {
+            frequencies[(size_t)i] = juce::mapToLog10((double)i / (double)(TRANSPARENCY_CHECK_POINTS - 1), (double)FILTER_MIN_HZ, maxFrequency);
+        }
+        setFrequencies(frequencies.data(), TRANSPARENCY_CHECK_POINTS, sampleRate);
+    }
+
+    int getNumFrequencies() const { return numPoints; }
+
+    // Writes the magnitude of the whole cascade in dB for every frequency, and its phase in radians if phases isn't null.
+    // Never allocates.
+    void evaluate(const BiquadCoefficients<double>* stages, int numStages, double* magnitudesDb, double* phases = nullptr) const {
+        alignas(SIMDDouble::SIMDRegisterSize) std::array<double, NumLanes> responseReal, responseImag, numeratorNorm, denominatorNorm;
+
+        for (int r = 0; r < numRegisters; ++r) {
+            SIMDDouble numeratorReal, numeratorImag, denominatorReal, denominatorImag;
+            multiplyStages(r, stages, numStages, numeratorReal, numeratorImag, denominatorReal, denominatorImag);
+
+            // H = N / D = N * conj(D) / |D|^2, the division is left to the per frequency pass below
+            (numeratorReal * denominatorReal + numeratorImag * denominatorImag).copyToRawArray(responseReal.data());
+            (numeratorImag * denominatorReal - numeratorReal * denominatorImag).copyToRawArray(responseImag.data());
+            (numeratorReal * numeratorReal + numeratorImag * numeratorImag).copyToRawArray(numeratorNorm.data());
+            (denominatorReal * denominatorReal + denominatorImag * denominatorImag).copyToRawArray(denominatorNorm.data());
+
+            int first = r * NumLanes;
+            int numLanesUsed = juce::jmin(NumLanes, numPoints - first);
+            for (int lane = 0; lane < numLanesUsed; ++lane) {
+                magnitudesDb[first + lane] = juce::Decibels::gainToDecibels(std::sqrt(numeratorNorm[(size_t)lane] / denominatorNorm[(size_t)lane]));
+            }
+            if (phases != nullptr) {
+                for (int lane = 0; lane < numLanesUsed; ++lane) {
+                    phases[first + lane] = std::atan2(responseImag[(size_t)lane], responseReal[(size_t)lane]);
+                }
+            }
+        }
+    }
+
+    // True if the cascade's magnitude stays within toleranceDb of 0dB at every frequency of the grid.
+    // Compares |N|^2 against |D|^2 scaled by the squared bounds, so there's no division or log per frequency. Never allocates.
+    bool isWithinDb(const BiquadCoefficients<double>* stages, int numStages, double toleranceDb) const {
+        const double upperBound = juce::Decibels::decibelsToGain(2.0 * toleranceDb);
+        const double lowerBound = juce::Decibels::decibelsToGain(-2.0 * toleranceDb);
+        alignas(SIMDDouble::SIMDRegisterSize) std::array<double, NumLanes> numeratorNorm, denominatorNorm;
+
+        for (int r = 0; r < numRegisters; ++r) {
+            SIMDDouble numeratorReal, numeratorImag, denominatorReal, denominatorImag;
+            multiplyStages(r, stages, numStages, numeratorReal, numeratorImag, denominatorReal, denominatorImag);
+            (numeratorReal * numeratorReal + numeratorImag * numeratorImag).copyToRawArray(numeratorNorm.data());
+            (denominatorReal * denominatorReal + denominatorImag * denominatorImag).copyToRawArray(denominatorNorm.data());
+
+            int first = r * NumLanes;
+            int numLanesUsed = juce::jmin(NumLanes, numPoints - first);
+            for (int lane = 0; lane < numLanesUsed; ++lane) {
+                double n = numeratorNorm[(size_t)lane];
+                double d = denominatorNorm[(size_t)lane];
+                if (n > d * upperBound || n < d * lowerBound) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    //==============================================================================
+    // Gathering the active stages, in cascade order, into a fixed array so evaluate() never needs to allocate
+
+    using StageArray = std::array<BiquadCoefficients<double>, CASCADE_STAGES>;
+
+    // From the designs the processor runs, with the bypass and slope settings they were designed from
+    static int collectStages(const ChainCoefficients& chainCoefficients, StageArray& stages) {
+        const ChainSettings& settings = chainCoefficients.settings;
+        int numStages = 0;
+
+        int numLowCutStages = getNumActiveStages(settings.lowCutSlope, settings.lowCutBypassed);
+        for (int i = 0; i < numLowCutStages; ++i) {
+            stages[(size_t)numStages++] = chainCoefficients.lowCut[(size_t)i].biquad;
+        }
+        if (!settings.peakBypassed) {
+            stages[(size_t)numStages++] = chainCoefficients.peak.biquad;
+        }
+        int numHighCutStages = getNumActiveStages(settings.highCutSlope, settings.highCutBypassed);
+        for (int i = 0; i < numHighCutStages; ++i) {
+            stages[(size_t)numStages++] = chainCoefficients.highCut[(size_t)i].biquad;
+        }
+        return numStages;
+    }
+
+private:
+    int numPoints = 0;
+    int numRegisters = 0;
+    // std::allocator honours SIMDDouble's alignment since C++17, so these can be loaded straight into registers
+    std::vector<SIMDDouble> cosW, negativeSinW, cos2W, negativeSin2W;
+
+    // Running products of every stage's numerator and denominator over register r of the grid
+    void multiplyStages(int r, const BiquadCoefficients<double>* stages, int numStages,
+                        SIMDDouble& numeratorReal, SIMDDouble& numeratorImag, SIMDDouble& denominatorReal, SIMDDouble& denominatorImag) const {
+        const SIMDDouble c1 = cosW[(size_t)r];
+        const SIMDDouble s1 = negativeSinW[(size_t)r];
+        const SIMDDouble c2 = cos2W[(size_t)r];
+        const SIMDDouble s2 = negativeSin2W[(size_t)r];
+
+        numeratorReal = SIMDDouble::expand(1.0);
+        numeratorImag = SIMDDouble::expand(0.0);
+        denominatorReal = SIMDDouble::expand(1.0);
+        denominatorImag = SIMDDouble::expand(0.0);
+
+        for (int stage = 0; stage < numStages; ++stage) {
+            const BiquadCoefficients<double>& b = stages[stage];
+            // N = b0 + b1 z^-1 + b2 z^-2 and D = 1 + a1 z^-1 + a2 z^-2 at z = e^jw
+            SIMDDouble stageNumeratorReal = c1 * b.b1 + c2 * b.b2 + b.b0;
+            SIMDDouble stageNumeratorImag = s1 * b.b1 + s2 * b.b2;
+            SIMDDouble stageDenominatorReal = c1 * b.a1 + c2 * b.a2 + 1.0;
+            SIMDDouble stageDenominatorImag = s1 * b.a1 + s2 * b.a2;
+
+            SIMDDouble productReal = numeratorReal * stageNumeratorReal - numeratorImag * stageNumeratorImag;
+            numeratorImag = numeratorReal * stageNumeratorImag + numeratorImag * stageNumeratorReal;
+            numeratorReal = productReal;
+
+            productReal = denominatorReal * stageDenominatorReal - denominatorImag * stageDenominatorImag;
+            denominatorImag = denominatorReal * stageDenominatorImag + denominatorImag * stageDenominatorReal;
+            denominatorReal = productReal;
+        }
+    }
+};
@@ -190,37 +190,156 @@ rightPathProducer(audioProcessor.rightChannelFifo) {
     for (juce::AudioProcessorParameter* param : params) {
         param->addListener(this);
     }
-    // update the monochain
+    // design the coefficients the curve is evaluated from
     updateChain();
 
-    startTimerHz(60);
+    analyzerThread->addProducer(&leftPathProducer);
+    analyzerThread->addProducer(&rightPathProducer);
+
+    // start out matching the saved parameter, the analyzer button only tells us about changes
+    toggleAnalysisEnablement(audioProcessor.apvts.getRawParameterValue(ANALYZER_ENABLED_NAME)->load() > 0.5f);
+
+    // the background layer covers every pixel, so nothing behind us needs painting first
+    setOpaque(true);
+
+    startTimer(StatsTimer, DSP_LOAD_REFRESH_MS);
+    wakeFrameTimer();
 }
 
 ResponseCurveComponent::~ResponseCurveComponent() {
+    // stop the audio thread feeding the fifos now there's nobody left to read them
+    toggleAnalysisEnablement(false);
+
+    // after this the analyzer thread won't touch our producers again
+    analyzerThread->removeProducer(&leftPathProducer);
+    analyzerThread->removeProducer(&rightPathProducer);
+
     const juce::Array <juce::AudioProcessorParameter*>& params = audioProcessor.getParameters();
     for (juce::AudioProcessorParameter* param : params) {
         param->removeListener(this);
     }
 }
 
+void ResponseCurveComponent::toggleAnalysisEnablement(bool enabled) {
+    shouldShowFFTAnlaysis = enabled;
+    leftPathProducer.setEnabled(enabled);
+    rightPathProducer.setEnabled(enabled);
+
+    if (enabled && !analyzerSubscribed) {
+        // the fifos hold audio from whenever we last unsubscribed, so don't let the first frames show it
+        leftPathProducer.requestReset();
+        rightPathProducer.requestReset();
+        audioProcessor.addAnalyzerSubscriber();
+        analyzerSubscribed = true;
+    }
+    else if (!enabled && analyzerSubscribed) {
+        audioProcessor.removeAnalyzerSubscriber();
+        analyzerSubscribed = false;
+    }
+
+    // once more so the paths appear or disappear, with the analyzer off the frame timer stops itself once the curve is up to date
+    repaint(getAnalysisArea());
+    if (enabled) {
+        wakeFrameTimer();
+    }
+}
+
 void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float newValue) {
     parametersChanged.set(true);
+    // automation can arrive on the audio thread, which mustn't touch timers, the stats timer picks those changes up instead
+    if (juce::MessageManager::existsAndIsCurrentThread()) {
+        wakeFrameTimer();
+    }
+}
+
+void PathProducer::setRenderSettings(juce::Rectangle<float> fftBounds, double sampleRate, int overlapChoice, bool latestFrameOnly) {
+    const juce::SpinLock::ScopedLockType lock(renderSettingsLock);
+    renderBounds = fftBounds;
+    renderSampleRate = sampleRate;
+    renderOverlapChoice = juce::jlimit(0, ANALYZER_OVERLAP_CHOICES.size() - 1, overlapChoice);
+    renderLatestFrameOnly = latestFrameOnly;
+}
+
+void PathProducer::shiftWindow(int numSamples) {
+    int windowSize = monoBuffer.getNumSamples();
+    float* window = monoBuffer.getWritePointer(0);
+
+    if (numSamples >= windowSize) {
+        // the whole window is replaced, so only the newest windowSize samples matter
+        channelFifo->skipSamples(numSamples - windowSize);
+        channelFifo->readSamples(window, windowSize);
+        return;
+    }
+
+    // first shift everything in the monoBuffer forward, then read the new samples straight into the end of it
+    juce::FloatVectorOperations::copy(window, window + numSamples, windowSize - numSamples);
+    channelFifo->readSamples(window + windowSize - numSamples, numSamples);
+}
+
+juce::Path PathProducer::getPath() {
+    pathBuffer.acquire();
+    return pathBuffer.getReadBuffer();
 }
 
 // This is where we need to coordinate the SingleChannelSampleFifo, FastFourierTransform Data generator, Path Producer, and GUI for Spectrum Analysis
-void PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate) {
-    juce::AudioBuffer<float> tempIncomingBuffer;
-
-    // When consuming the buffer, we take a number of sampled points of the sample size, run the FFT algorithm on that block, 
-    // then shift the buffer forward by that sample size to take on the next block of sample points
-    while (channelFifo->getNumcompleteBuffersAvailable() > 0) {
-        if (channelFifo->getAudioBuffer(tempIncomingBuffer)) {
-            // first shift everything in the monoBuffer forward by however many samples are in the temp buffer
-            int size = tempIncomingBuffer.getNumSamples();
-            juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, 0), monoBuffer.getReadPointer(0, size), monoBuffer.getNumSamples() - size);
-            juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, monoBuffer.getNumSamples() - size), tempIncomingBuffer.getReadPointer(0, 0), size);
-
-            fftDataGenerator.produceFFtDataForRendering(monoBuffer, ABSOLUTE_MINIMUM_GAIN); // Our scale only goes to -48dB, so we'll use that as our "negative infinity" for now
+void PathProducer::process() {
+    if (!enabled.get()) {
+        return;
+    }
+
+    // prepareToPlay can reallocate the ring while editors are open, so keep hold of it while reading.
+    // If prepare has it right now, this tick is skipped rather than blocking the shared analyzer thread.
+    const juce::ScopedTryLock ringLock(channelFifo->getReaderLock());
+    if (!ringLock.isLocked() || !channelFifo->isPrepared()) {
+        return;
+    }
+
+    if (resetPending.compareAndSetBool(false, true)) {
+        channelFifo->skipSamples(channelFifo->getNumSamplesAvailable());
+        monoBuffer.clear();
+        pathBuffer.getWriteBuffer().clear();
+        pathBuffer.publish();
+    }
+
+    juce::Rectangle<float> fftBounds;
+    double sampleRate;
+    int overlapChoice;
+    bool latestFrameOnly;
+    {
+        const juce::SpinLock::ScopedLockType lock(renderSettingsLock);
+        fftBounds = renderBounds;
+        sampleRate = renderSampleRate;
+        overlapChoice = renderOverlapChoice;
+        latestFrameOnly = renderLatestFrameOnly;
+    }
+    if (fftBounds.isEmpty() || sampleRate <= 0.0) {
+        return; // the editor hasn't been laid out yet
+    }
+
+    // When consuming the ring, we take one hop's worth of sample points, shift the window forward by that many samples,
+    // then run the FFT algorithm on the window. The overlap choice halves the hop each step: 0%, 50%, 75%, 87.5% of the window.
+    int windowSize = monoBuffer.getNumSamples();
+    int hopSize = windowSize >> overlapChoice;
+    int framesDue = channelFifo->getNumSamplesAvailable() / hopSize;
+
+    // frames older than one full window would be shifted straight back out again, so don't bother analysing them
+    int maxFrames = windowSize / hopSize;
+    if (framesDue > maxFrames) {
+        channelFifo->skipSamples((framesDue - maxFrames) * hopSize);
+        framesDue = maxFrames;
+    }
+
+    if (framesDue > 0) {
+        if (latestFrameOnly) {
+            // only the newest path gets drawn, so jump the window straight to the newest frame and do a single FFT
+            shiftWindow(framesDue * hopSize);
+            fftDataGenerator.produceFFtDataForRendering(monoBuffer, ABSOLUTE_MINIMUM_GAIN);
+        }
+        else {
+            for (int frame = 0; frame < framesDue; ++frame) {
+                shiftWindow(hopSize);
+                fftDataGenerator.produceFFtDataForRendering(monoBuffer, ABSOLUTE_MINIMUM_GAIN); // Our scale only goes to -48dB, so we'll use that as our "negative infinity" for now
+            }
         }
     }
 
@@ -237,120 +356,168 @@ void PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate)
     }
 
     // Pull the most recent path that has been produced, since that will be the most recent data to use - this is in case we can't pull the paths as fast as we make them
+    bool newPath = false;
     while (pathProducer.getNumPathsAvailable()) {
-        pathProducer.getPath(fftPath);
+        newPath = pathProducer.getPath(pathBuffer.getWriteBuffer()) || newPath;
+    }
+    if (newPath) {
+        pathBuffer.publish();
+    }
+}
+
+void ResponseCurveComponent::timerCallback(int timerID) {
+    if (timerID == FrameTimer) {
+        frameTimerCallback();
+        return;
+    }
+
+    // the load only moves while the host is processing, so once it stops the readout stops repainting too
+    if (updateStatsText()) {
+        repaint(getStatsArea());
+    }
+    if (needsCurveUpdate()) {
+        wakeFrameTimer();
+    }
+}
+
+// how much of each block's time processBlock is using, so an instance that is close to its deadline stands out.
+// Returns whether the text changed since the last call.
+bool ResponseCurveComponent::updateStatsText() {
+    RealtimeStats::Snapshot stats = audioProcessor.getRealtimeStats();
+    juce::String text;
+    if (stats.numBlocks > 0) {
+        text << "DSP " << juce::String(stats.averageLoad, 1) << "% avg, " << juce::String(stats.p99Load, 1) << "% p99";
+        if (stats.numOverruns > 0) {
+            text << ", " << stats.numOverruns << " overruns";
+        }
+    }
+    statsHaveOverruns = stats.numOverruns > 0;
+
+    if (text == statsText) {
+        return false;
+    }
+    statsText = text;
+    return true;
+}
+
+void ResponseCurveComponent::wakeFrameTimer() {
+    if (!isTimerRunning(FrameTimer)) {
+        startTimer(FrameTimer, EDITOR_FRAME_INTERVAL_MS);
     }
 }
 
-void ResponseCurveComponent::timerCallback() {
+// the coefficients depend on the sample rate too, so a change there needs the same rebuild as a parameter change
+bool ResponseCurveComponent::needsCurveUpdate() {
+    return parametersChanged.get() || audioProcessor.getSampleRate() != responseCurveSampleRate;
+}
+
+void ResponseCurveComponent::frameTimerCallback() {
+    // the analysis itself runs on the analyzer thread, this just keeps it up to date with our size, the sample rate and the analyzer settings
     if (shouldShowFFTAnlaysis) {
         juce::Rectangle<float> fftBounds = getAnalysisArea().toFloat();
         double sampleRate = audioProcessor.getSampleRate();
 
-        leftPathProducer.process(fftBounds, sampleRate);
-        rightPathProducer.process(fftBounds, sampleRate);
+        int overlapChoice = (int)audioProcessor.apvts.getRawParameterValue(ANALYZER_OVERLAP_NAME)->load();
+        bool latestFrameOnly = audioProcessor.apvts.getRawParameterValue(ANALYZER_LATEST_FRAME_ONLY_NAME)->load() > 0.5f;
+
+        leftPathProducer.setRenderSettings(fftBounds, sampleRate, overlapChoice, latestFrameOnly);
+        rightPathProducer.setRenderSettings(fftBounds, sampleRate, overlapChoice, latestFrameOnly);
     }
 
-    if (parametersChanged.compareAndSetBool(false, true)) {
+    if (needsCurveUpdate()) {
+        parametersChanged.set(false);
         DBG("params changed");
-        // update the monochain
+        // redesign the coefficients, then evaluate the curve from them
         updateChain();
-        // signal a repaint
-        //repaint();
+        updateResponseCurve();
+        // the stroke can poke a pixel outside the analysis area, so take in the whole render area
+        repaint(getRenderArea());
+    }
+    else if (shouldShowFFTAnlaysis) {
+        // new spectrum analysis paths are being made all the time, but only inside the analysis area
+        repaint(getAnalysisArea());
+    }
+    else {
+        // nothing is moving, so go idle until a parameter changes or the analyzer is switched on
+        stopTimer(FrameTimer);
     }
-    // Now need to repaint all the time since we have new spectrum analysis paths being made all the time
-    repaint();
 }
 
 void ResponseCurveComponent::updateChain() {
     ChainSettings chainSettings = getChainSettings(audioProcessor.apvts);
 
-    monoChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
-    monoChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
-    monoChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
-
-    Coefficients peakCoefficients = makePeakFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-
-    auto lowCutCoefficients = makeLowCutFilter(chainSettings, audioProcessor.getSampleRate());
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, audioProcessor.getSampleRate());
-
-    updateCutFilter(monoChain.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilter(monoChain.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+    double sampleRate = audioProcessor.getSampleRate();
+    designLowCut(responseCoefficients, chainSettings, sampleRate);
+    designPeak(responseCoefficients, chainSettings, sampleRate);
+    designHighCut(responseCoefficients, chainSettings, sampleRate);
+
+    // draw what the processor actually runs, with the transparent bands dropped the same way
+    if (sampleRate != audibleBandSampleRate) {
+        audibleBand.setAudibleBand(sampleRate);
+        audibleBandSampleRate = sampleRate;
+    }
+    float toleranceDb = audioProcessor.getFlatBandTolerance();
+    responseCoefficients.settings = bypassTransparentBands(findTransparentCuts(chainSettings, responseCoefficients, audibleBand, toleranceDb), toleranceDb);
 }
 
-void ResponseCurveComponent::paint(juce::Graphics& g) {
-    // doing this so we don't have to write `juce::` everywhere in this function
+// Recomputes the curve magnitudes from responseCoefficients and rebuilds the cached path, paint only ever strokes the result
+void ResponseCurveComponent::updateResponseCurve() {
     using namespace juce;
-    g.fillAll(Colours::black);
-
-    g.drawImage(background, getLocalBounds().toFloat());
-
     Rectangle<int> responseArea = getAnalysisArea();
+    responseCurveSampleRate = audioProcessor.getSampleRate();
+    responseCurve.clear();
 
-    int width = responseArea.getWidth();
-    CutFilter& lowcut = monoChain.get<ChainPositions::LowCut>();
-    Filter& peak = monoChain.get<ChainPositions::Peak>();
-    CutFilter& highcut = monoChain.get<ChainPositions::HighCut>();
-
-    double sampleRate = audioProcessor.getSampleRate();
-    std::vector<double> magnitudes;
-    magnitudes.resize(width);
-
-    for (int i = 0; i < width; ++i) {
-        double magnitude = 1.f;
-        double freq = mapToLog10(double(i) / double(width), 20.0, 20000.0);
-
-        if (!monoChain.isBypassed<ChainPositions::Peak>()) {
-            magnitude *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        }
-
-        // check each filter in the CutChains
-        if (!monoChain.isBypassed<ChainPositions::LowCut>()) {
-            if (!lowcut.isBypassed<0>()) {
-                magnitude *= lowcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-            if (!lowcut.isBypassed<1>()) {
-                magnitude *= lowcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-            if (!lowcut.isBypassed<2>()) {
-                magnitude *= lowcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-            if (!lowcut.isBypassed<3>()) {
-                magnitude *= lowcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-        }
-
-        if (!monoChain.isBypassed<ChainPositions::HighCut>()) {
-            if (!highcut.isBypassed<0>()) {
-                magnitude *= highcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-            if (!highcut.isBypassed<1>()) {
-                magnitude *= highcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-            if (!highcut.isBypassed<2>()) {
-                magnitude *= highcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-            if (!highcut.isBypassed<3>()) {
-                magnitude *= highcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-        }
+    if (responseArea.getWidth() <= 0) {
+        responseCurveImage = Image();
+        return;
+    }
 
-        magnitudes[i] = Decibels::gainToDecibels(magnitude);
+    // one frequency per pixel column, the trig for the grid is only redone when the width or sample rate changes
+    int width = responseArea.getWidth();
+    if (width != responseEvaluator.getNumFrequencies() || responseCurveSampleRate != responseEvaluatorSampleRate) {
+        responseEvaluator.setLogFrequencies(width, FILTER_MIN_HZ, FILTER_MAX_HZ, responseCurveSampleRate);
+        responseEvaluatorSampleRate = responseCurveSampleRate;
+        responseMagnitudes.resize((size_t)width);
     }
 
-    Path responseCurve;
+    FrequencyResponseEvaluator::StageArray stages;
+    int numStages = FrequencyResponseEvaluator::collectStages(responseCoefficients, stages);
+    responseEvaluator.evaluate(stages.data(), numStages, responseMagnitudes.data());
+
     const double outputMin = responseArea.getBottom();
     const double outputMax = responseArea.getY();
     auto map = [outputMin, outputMax](double input) {
         return jmap(input, -24.0, 24.0, outputMin, outputMax);
     };
 
-    responseCurve.startNewSubPath(responseArea.getX(), map(magnitudes.front()));
+    responseCurve.preallocateSpace(3 * (int)responseMagnitudes.size());
+    responseCurve.startNewSubPath(responseArea.getX(), map(responseMagnitudes.front()));
+
+    for (size_t i = 1; i < responseMagnitudes.size(); ++i) {
+        responseCurve.lineTo(responseArea.getX() + i, map(responseMagnitudes[i]));
+    }
 
-    for (size_t i = 1; i < magnitudes.size(); ++i) {
-        responseCurve.lineTo(responseArea.getX() + i, map(magnitudes[i]));
+    // the curve gets its own transparent layer, so each frame only blits it instead of stroking it again
+    if (responseCurveImage.getWidth() != getWidth() || responseCurveImage.getHeight() != getHeight()) {
+        responseCurveImage = Image(Image::PixelFormat::ARGB, getWidth(), getHeight(), true);
     }
+    else {
+        responseCurveImage.clear(responseCurveImage.getBounds());
+    }
+    Graphics g(responseCurveImage);
+    g.setColour(Colours::white);
+    g.strokePath(responseCurve, PathStrokeType(2.f));
+}
+
+void ResponseCurveComponent::paint(juce::Graphics& g) {
+    // doing this so we don't have to write `juce::` everywhere in this function
+    using namespace juce;
+    // Layers, back to front: the grid and labels (rebuilt on resize), the analyzer paths (new every frame),
+    // then the response curve (rebuilt when the parameters change). Most frames only repaint the analysis area,
+    // so the two cached layers are just blitted there.
+    g.drawImageAt(background, 0, 0);
+
+    Rectangle<int> responseArea = getAnalysisArea();
 
     if (shouldShowFFTAnlaysis) {
         Path leftChannelFFTPath = leftPathProducer.getPath();
@@ -366,17 +533,23 @@ void ResponseCurveComponent::paint(juce::Graphics& g) {
         g.strokePath(rightChannelFFTPath, PathStrokeType(1.f));
     }
 
-    g.setColour(Colours::orange);
-    g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
+    if (responseCurveImage.isValid()) {
+        g.drawImageAt(responseCurveImage, 0, 0);
+    }
 
-    g.setColour(Colours::white);
-    g.strokePath(responseCurve, PathStrokeType(2.f));
+    // the load readout as the stats timer last saw it
+    if (statsText.isNotEmpty()) {
+        g.setColour(statsHaveOverruns ? Colours::red : Colours::lightgrey);
+        g.setFont(DSP_LOAD_FONT_HEIGHT);
+        g.drawFittedText(statsText, getStatsArea(), Justification::bottomRight, NUMBER_OF_LINES_TEXT);
+    }
 }
 
 void ResponseCurveComponent::resized() {
     using namespace juce;
     background = Image(Image::PixelFormat::RGB, getWidth(), getHeight(), true);
     Graphics g(background);
+    g.fillAll(Colours::black);
     g.setColour(Colours::white);
     juce::Rectangle<int> renderArea = getAnalysisArea();
     int left = renderArea.getX();
@@ -469,6 +642,12 @@ void ResponseCurveComponent::resized() {
         g.setColour(Colours::lightgrey);
         g.drawFittedText(str, r, juce::Justification::centred, NUMBER_OF_LINES_TEXT);
     }
+
+    g.setColour(Colours::orange);
+    g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
+
+    // the curve is laid out in the analysis area, so it moves with the size
+    updateResponseCurve();
 }
 
 juce::Rectangle<int> ResponseCurveComponent::getRenderArea() {
@@ -485,6 +664,10 @@ juce::Rectangle<int> ResponseCurveComponent::getRenderArea() {
     return bounds;
 }
 
+juce::Rectangle<int> ResponseCurveComponent::getStatsArea() {
+    return getAnalysisArea().reduced(DEFAULT_PADDING).removeFromBottom(DSP_LOAD_FONT_HEIGHT + TEXT_BOUNDING_BOX_ADD_HEIGHT);
+}
+
 juce::Rectangle<int> ResponseCurveComponent::getAnalysisArea() {
     juce::Rectangle<int> bounds = getRenderArea();
     bounds.removeFromTop(ANALYSIS_AREA_PADDING);
@@ -10,6 +10,7 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "FrequencyResponse.h"
 
 enum FFTOrder {
     // Splits spectrum of 20Hz - 20000Hz into N equally sized frequency bins
@@ -17,6 +18,102 @@ enum FFTOrder {
     order4096 = 12,
     order8192 = 13
 };
+// Process-wide cache of FFT engines and window tables keyed by order and window type, so every analyzer of every
+// SimpleEQ instance with the same settings shares one set of tables. Hold it through a juce::SharedResourcePointer.
+// Entries are immutable once built: the FFT is only used through its const transforms and the window table is only read.
+struct FFTCache {
+    using WindowingMethod = juce::dsp::WindowingFunction<float>::WindowingMethod;
+
+    struct Entry : juce::ReferenceCountedObject {
+        Entry(int fftOrder, WindowingMethod windowingMethod) : order(fftOrder), method(windowingMethod), fft(fftOrder) {
+            // the raw table rather than a WindowingFunction, so the window can be applied while copying the samples in
+            windowTable.resize((size_t)(1 << fftOrder));
+            juce::dsp::WindowingFunction<float>::fillWindowingTables(windowTable.data(), windowTable.size(), windowingMethod, true);
+        }
+
+        const int order;
+        const WindowingMethod method;
+        const juce::dsp::FFT fft;
+        std::vector<float> windowTable;
+    };
+    using EntryPtr = juce::ReferenceCountedObjectPtr<Entry>;
+
+    EntryPtr get(int order, WindowingMethod method) {
+        const juce::ScopedLock lock(entryLock);
+
+        // drop anything that only the cache is still holding on to
+        for (int i = entries.size(); --i >= 0;) {
+            if (entries.getObjectPointerUnchecked(i)->getReferenceCount() == 1) {
+                entries.remove(i);
+            }
+        }
+
+        for (Entry* entry : entries) {
+            if (entry->order == order && entry->method == method) {
+                return entry;
+            }
+        }
+        return entries.add(new Entry(order, method));
+    }
+
+private:
+    juce::CriticalSection entryLock;
+    juce::ReferenceCountedArray<Entry> entries;
+};
+
+// Replaces each of the numBins magnitudes with 20 * log10(magnitude * scale), clamped from below at floorDb, in one pass.
+// Runs a SIMDRegister<float> of bins at a time. SIMDRegister has no shifts, int conversions or division, so the float's
+// exponent is read off its bits one mask test at a time, and the mantissa is folded into [sqrt(0.5), sqrt(2)) for a short
+// polynomial in (mantissa - 1) (within 0.0002dB of std::log10). There are no calls or branches per bin. Zero magnitudes land on the floor.
+inline void convertMagnitudesToDecibels(float* magnitudes, int numBins, float scale, float floorDb) {
+    using SIMDMask = SIMDFloat::vMaskType;
+    constexpr int NumLanes = (int)SIMDFloat::SIMDNumElements;
+    const float decibelsPerOctave = 6.02059991f; // 20 * log10(2)
+
+    const SIMDMask mantissaBits = SIMDMask::expand(0x007fffffu);
+    const SIMDMask exponentOfOne = SIMDMask::expand(0x3f800000u);
+    const SIMDFloat zero = SIMDFloat::expand(0.f);
+    const SIMDFloat one = SIMDFloat::expand(1.f);
+    const SIMDFloat sqrtTwo = SIMDFloat::expand(1.41421356f);
+    const SIMDFloat floor = SIMDFloat::expand(floorDb);
+    const SIMDFloat infinity = SIMDFloat::expand(std::numeric_limits<float>::infinity());
+    // the scale and the exponent bias folded into one offset
+    const SIMDFloat offsetDb = SIMDFloat::expand(20.f * std::log10(scale) - 127.f * decibelsPerOctave);
+
+    alignas(SIMDFloat::SIMDRegisterSize) std::array<float, NumLanes> lanes;
+    for (int first = 0; first < numBins; first += NumLanes) {
+        // the bins aren't SIMD aligned and the last register may be partly used, so load and store through an aligned copy
+        int numLanesUsed = juce::jmin(NumLanes, numBins - first);
+        lanes.fill(0.f);
+        std::memcpy(lanes.data(), magnitudes + first, sizeof(float) * (size_t)numLanesUsed);
+        const SIMDFloat magnitude = SIMDFloat::fromRawArray(lanes.data());
+
+        // the biased exponent, a bit at a time. Each test leaves either 0 or a normal float, so comparing with zero is exact.
+        SIMDFloat exponent = zero;
+        for (int bit = 0; bit < 8; ++bit) {
+            SIMDMask isSet = SIMDFloat::notEqual(magnitude & SIMDMask::expand(1u << (23 + bit)), zero);
+            exponent += SIMDFloat::expand((float)(1 << bit)) & isSet;
+        }
+
+        // the mantissa in [1, 2), halved above sqrt(2) with the exponent bumped to match, so it sits either side of 1
+        SIMDFloat mantissa = (magnitude & mantissaBits) | exponentOfOne;
+        SIMDMask isHigh = SIMDFloat::greaterThan(mantissa, sqrtTwo);
+        mantissa -= (mantissa * 0.5f) & isHigh;
+        exponent += one & isHigh;
+
+        // log2(1 + u) = u * P(u), least squares fit over u in [sqrt(0.5) - 1, sqrt(2) - 1)
+        SIMDFloat u = mantissa - one;
+        SIMDFloat log2Mantissa = u * ((((u * 0.242392708f - 0.39246483f) * u + 0.488226395f) * u - 0.720400989f) * u + 1.44252159f);
+
+        // zero has no exponent to read, so push it to -inf and let the floor catch it
+        SIMDFloat decibels = (exponent + log2Mantissa) * decibelsPerOctave + offsetDb;
+        decibels -= infinity & SIMDFloat::equal(magnitude, zero);
+        decibels = SIMDFloat::max(decibels, floor);
+        decibels.copyToRawArray(lanes.data());
+        std::memcpy(magnitudes + first, lanes.data(), sizeof(float) * (size_t)numLanesUsed);
+    }
+}
+
 // Fast Fourier Transform for converting audio buffer data into FastFourierTransform DataBlocks
 // According to the course:
     // Host Buffer has x samples -> SingleChannelSampleFifo -> Fixed size Blocks -> Fast Fourier Transform DataGenerator ->
@@ -28,39 +125,27 @@ struct FFTDataGenerator {
     */
     void produceFFtDataForRendering(const juce::AudioBuffer<float>& audioData, const float negativeInfinity) {
         const int fftSize = getFFtSize();
-        fftData.assign(fftData.size(), 0);
-        auto* readIndex = audioData.getReadPointer(0);
-        std::copy(readIndex, readIndex + fftSize, fftData.begin());
 
-        // first apply a windowing function to our data
-        window->multiplyWithWindowingTable(fftData.data(), fftSize);        // [1]
+        // first apply a windowing function to our data while copying it in, the upper half is workspace for the transform
+        // so it only needs clearing. The window has to be applied before the transform, so it can't share the dB pass below.
+        juce::FloatVectorOperations::multiply(fftData.data(), audioData.getReadPointer(0), fftResources->windowTable.data(), fftSize);   // [1]
+        juce::FloatVectorOperations::clear(fftData.data() + fftSize, fftSize);
         // then render our FFT data
-        forwardFFT->performFrequencyOnlyForwardTransform(fftData.data());   // [2]
+        fftResources->fft.performFrequencyOnlyForwardTransform(fftData.data());   // [2]
 
+        // normalize the fft values and convert them to decibels in the same pass
         int numBins = (int)fftSize / 2;
-        // TODO combine the below into the same for loop, probably makes no difference
-        //normalize the fft values
-        for (int i = 0; i < numBins; ++i) {
-            fftData[i] /= (float)numBins;
-        }
-
-        //convert them to decibels
-        for (int i = 0; i < numBins; ++i) {
-            fftData[i] = juce::Decibels::gainToDecibels(fftData[i], negativeInfinity);
-        }
+        convertMagnitudesToDecibels(fftData.data(), numBins, 1.f / (float)numBins, negativeInfinity);
 
         fftDataFifo.push(fftData);
     }
 
     void changeOrder(FFTOrder newOrder) {
-        // when you change order, recreate the window, forwardFFT, fifo, fftData
-        // also reset the fifoIndex
-        // things that need recreating should be created on the heap via std::make_unique<>
+        // when you change order, pick up the shared window and forwardFFT for it, and recreate the fifo and fftData
         order = newOrder;
         int fftSize = getFFtSize();
 
-        forwardFFT = std::make_unique<juce::dsp::FFT>(order);
-        window = std::make_unique<juce::dsp::WindowingFunction<float>>(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+        fftResources = fftCache->get(order, juce::dsp::WindowingFunction<float>::blackmanHarris);
 
         fftData.clear();
         fftData.resize(fftSize * 2, 0);
@@ -76,51 +161,71 @@ struct FFTDataGenerator {
 private:
     FFTOrder order;
     BlockType fftData;
-    std::unique_ptr<juce::dsp::FFT> forwardFFT;
-    std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+    juce::SharedResourcePointer<FFTCache> fftCache;
+    FFTCache::EntryPtr fftResources; // window table and forward FFT, shared with every other generator of the same order
 
     Fifo<BlockType> fftDataFifo;
 };
 
+// How the bins that fall into one pixel column are combined into the single level drawn for it
+enum BinReduction {
+    Reduce_Max, // loudest bin, peaks stay visible however many bins share a column
+    Reduce_RMS  // average power of the bins
+};
+
 // Generates the Path data for the Spectrum Analysis by being fed the fft data
 template<typename PathType>
 struct AnalyzerPathGenerator {
-    // Converts 'renderData[]' into a juce::Path
+    // Converts 'renderData[]' into a juce::Path with at most one point per pixel column.
+    // Each column covers a slice of the log frequency axis and reduces every bin inside it to one level,
+    // columns at the low end that no bin falls into are skipped and bridged by the line between their neighbours.
     void generatePath(const std::vector<float>& renderData, juce::Rectangle<float> fftBounds, int fftSize, float binWidth, float negativeInfinity) {
         float top = fftBounds.getY();
         float bottom = fftBounds.getHeight();
-        float width = fftBounds.getWidth();
+        int numColumns = (int)fftBounds.getWidth();
         int numBins = (int)fftSize / 2;
+
+        // the column to bin table only depends on these, so it's rebuilt on a resize, sample rate or order change rather than every frame
+        if (numColumns != mapNumColumns || numBins != mapNumBins || binWidth != mapBinWidth) {
+            buildColumnMap(numColumns, numBins, binWidth);
+        }
+
         PathType p;
-        p.preallocateSpace(3 * (int)fftBounds.getWidth());
+        p.preallocateSpace(3 * numColumns);
 
         auto map = [bottom, top, negativeInfinity](float v) {
             return juce::jmap(v, negativeInfinity, 0.f, float(bottom), top);
         };
 
-        auto y = map(renderData[0]);
-        // assert that y is a number and is not infinite
-        jassert(!std::isnan(y) && !std::isinf(y));
-        // start the path here
-        p.startNewSubPath(0, y);
-        const int pathResolution = 2; // you can draw line-to's every 'pathResolution' pixels.
+        bool pathStarted = false;
+        for (int column = 0; column < numColumns; ++column) {
+            int firstBin = columnFirstBins[(size_t)column];
+            int endBin = columnFirstBins[(size_t)column + 1];
+            if (firstBin >= endBin) {
+                continue;
+            }
 
-        // create the rest of the path here
-        for (int binNum = 1; binNum < numBins; binNum += pathResolution) {
-            y = map(renderData[binNum]);
+            float y = map(reduceBins(renderData, firstBin, endBin));
             // assert that y is a number and is not infinite
             jassert(!std::isnan(y) && !std::isinf(y));
+            if (std::isnan(y) || std::isinf(y)) {
+                continue;
+            }
 
-            if (!std::isnan(y) && !std::isinf(y)) {
-                float binFreq = binNum * binWidth;
-                float normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
-                int binX = std::floor(normalizedBinX * width);
-                p.lineTo(binX, y);
+            if (pathStarted) {
+                p.lineTo((float)column, y);
+            }
+            else {
+                // start the path here
+                p.startNewSubPath((float)column, y);
+                pathStarted = true;
             }
         }
         pathFifo.push(p);
     }
 
+    void setBinReduction(BinReduction newReduction) { reduction = newReduction; }
+
     int getNumPathsAvailable() const {
         return pathFifo.getNumAvailableForReading();
     }
@@ -130,6 +235,45 @@ struct AnalyzerPathGenerator {
     }
 private:
     Fifo<PathType> pathFifo;
+    BinReduction reduction = Reduce_Max;
+
+    // Column c draws bins [columnFirstBins[c], columnFirstBins[c + 1]), numColumns + 1 entries
+    std::vector<int> columnFirstBins;
+    int mapNumColumns = -1;
+    int mapNumBins = -1;
+    float mapBinWidth = 0.f;
+
+    void buildColumnMap(int numColumns, int numBins, float binWidth) {
+        columnFirstBins.resize((size_t)numColumns + 1);
+        for (int column = 0; column <= numColumns; ++column) {
+            // the first bin whose frequency is at or above this column's left edge, DC never falls inside the 20Hz - 20KHz axis
+            float edgeFreq = juce::mapToLog10((float)column / (float)numColumns, FILTER_MIN_HZ, FILTER_MAX_HZ);
+            int bin = (int)std::ceil(edgeFreq / binWidth);
+            columnFirstBins[(size_t)column] = juce::jlimit(1, numBins, bin);
+        }
+
+        mapNumColumns = numColumns;
+        mapNumBins = numBins;
+        mapBinWidth = binWidth;
+    }
+
+    float reduceBins(const std::vector<float>& renderData, int firstBin, int endBin) const {
+        if (reduction == Reduce_RMS) {
+            // average in power, the bins are already in decibels and clamped to the floor so the mean is never zero
+            float meanPower = 0.f;
+            for (int bin = firstBin; bin < endBin; ++bin) {
+                meanPower += std::pow(10.f, renderData[(size_t)bin] / 10.f);
+            }
+            meanPower /= (float)(endBin - firstBin);
+            return 10.f * std::log10(meanPower);
+        }
+
+        float level = renderData[(size_t)firstBin];
+        for (int bin = firstBin + 1; bin < endBin; ++bin) {
+            level = juce::jmax(level, renderData[(size_t)bin]);
+        }
+        return level;
+    }
 };
 
 struct LookAndFeel : juce::LookAndFeel_V4 {
@@ -176,6 +320,8 @@ private:
     juce::String suffix;
 };
 
+// Turns one channel of the analyzer tap into a juce::Path. process() runs on the shared AnalyzerThread,
+// the editor only picks up the finished path through a triple buffer, so neither side ever waits for the other.
 struct PathProducer {
     PathProducer(SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType>& scsf) : channelFifo(&scsf) {
         // use order of 8192 for best resolution of lower end of spectrum
@@ -184,17 +330,81 @@ struct PathProducer {
         fftDataGenerator.changeOrder(FFTOrder::order8192);
         monoBuffer.setSize(1, fftDataGenerator.getFFtSize());
     }
-    void process(juce::Rectangle<float> fftBounds, double sampleRate);
-    juce::Path getPath() { return fftPath; }
+
+    // Message thread: where the path should be drawn, what sample rate the audio is at and how often to analyse, picked up on the next process().
+    // overlapChoice indexes ANALYZER_OVERLAP_CHOICES. With latestFrameOnly, each process() does at most one FFT on the newest frame
+    // instead of one per hop, so the FFT work is bounded by the analyzer thread's rate rather than the overlap.
+    void setRenderSettings(juce::Rectangle<float> fftBounds, double sampleRate, int overlapChoice, bool latestFrameOnly);
+    void setEnabled(bool shouldBeEnabled) { enabled.set(shouldBeEnabled); }
+    // Before the next analysis, throw away everything waiting in the fifo along with the current window and path,
+    // so the analyzer starts from fresh audio rather than whatever was left over from the last time it was shown
+    void requestReset() { resetPending.set(true); }
+
+    // Analyzer thread
+    void process();
+
+    // Message thread: the newest finished path
+    juce::Path getPath();
 private:
     SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType>* channelFifo;
     juce::AudioBuffer<float> monoBuffer;
     FFTDataGenerator<std::vector<float>> fftDataGenerator;
     AnalyzerPathGenerator<juce::Path> pathProducer;
-    juce::Path fftPath;
+
+    juce::Atomic<bool> enabled{ true };
+    juce::Atomic<bool> resetPending{ false };
+    juce::SpinLock renderSettingsLock;
+    juce::Rectangle<float> renderBounds;
+    double renderSampleRate = 0.0;
+    int renderOverlapChoice = ANALYZER_OVERLAP_DEFAULT_POS;
+    bool renderLatestFrameOnly = ANALYZER_LATEST_FRAME_ONLY_DEFAULT;
+
+    // Moves the analysis window forward by numSamples, reading them from the ring
+    void shiftWindow(int numSamples);
+
+    TripleBuffer<juce::Path> pathBuffer;
+};
+
+// One background thread shared by every open SimpleEQ editor that runs all of their analyzers,
+// so the FFTs and path building stay off the message thread. Hold it through a juce::SharedResourcePointer.
+struct AnalyzerThread : juce::Thread {
+    AnalyzerThread() : juce::Thread("SimpleEQ Analyzer") {
+        startThread();
+    }
+
+    ~AnalyzerThread() override {
+        stopThread(ANALYZER_THREAD_STOP_TIMEOUT_MS);
+    }
+
+    // Once removeProducer returns the thread is guaranteed not to be inside that producer's process()
+    void addProducer(PathProducer* producer) {
+        const juce::ScopedLock lock(producerLock);
+        producers.addIfNotAlreadyThere(producer);
+    }
+
+    void removeProducer(PathProducer* producer) {
+        const juce::ScopedLock lock(producerLock);
+        producers.removeFirstMatchingValue(producer);
+    }
+
+    void run() override {
+        while (!threadShouldExit()) {
+            {
+                const juce::ScopedLock lock(producerLock);
+                for (PathProducer* producer : producers) {
+                    producer->process();
+                }
+            }
+            wait(ANALYZER_THREAD_INTERVAL_MS);
+        }
+    }
+
+private:
+    juce::CriticalSection producerLock;
+    juce::Array<PathProducer*> producers;
 };
 
-struct ResponseCurveComponent : juce::Component, juce::AudioProcessorParameter::Listener, juce::Timer
+struct ResponseCurveComponent : juce::Component, juce::AudioProcessorParameter::Listener, juce::MultiTimer
 {
 public:
     ResponseCurveComponent(SimpleEQAudioProcessor&);
@@ -202,14 +412,12 @@ public:
 
     void parameterValueChanged(int parameterIndex, float newValue) override;
     void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override { };
-    void timerCallback() override;
+    void timerCallback(int timerID) override;
 
     void paint(juce::Graphics& g) override;
     void resized() override;
 
-    void toggleAnalysisEnablement(bool enabled) {
-        shouldShowFFTAnlaysis = enabled;
-    }
+    void toggleAnalysisEnablement(bool enabled);
 private:
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
@@ -217,17 +425,47 @@ private:
 
     juce::Atomic<bool> parametersChanged{ false };
 
-    MonoChain monoChain;
+    // designed the same way as the processor's cascade, so the curve shows whichever design each band uses
+    ChainCoefficients responseCoefficients;
+    // the same audible band grid the processor checks the cuts over before dropping them
+    FrequencyResponseEvaluator audibleBand;
+    double audibleBandSampleRate = 0.0;
 
     void updateChain();
 
+    // The response curve only changes with the parameters, sample rate or size, so it is built once per change rather than every paint
+    juce::Path responseCurve;
+    juce::Image responseCurveImage; // the curve layer, transparent apart from the stroked curve
+    std::vector<double> responseMagnitudes;
+    double responseCurveSampleRate = 0.0;
+    FrequencyResponseEvaluator responseEvaluator;
+    double responseEvaluatorSampleRate = 0.0;
+    void updateResponseCurve();
+
     juce::Image background;
     juce::Rectangle<int> getRenderArea();
     juce::Rectangle<int> getAnalysisArea();
+    juce::Rectangle<int> getStatsArea(); // where the DSP load readout goes, bottom right of the analysis area
+    juce::String statsText; // the last load readout, only repainted when it changes
+    bool statsHaveOverruns = false;
+    bool updateStatsText();
+
+    // The frame timer only runs while something on screen is moving: the analyzer, or a curve waiting to be rebuilt.
+    // The stats timer always runs, slowly, catching parameter changes made off the message thread and checking the load readout,
+    // which it only repaints when the text has changed, so an editor with nothing playing and the analyzer off never repaints.
+    enum TimerIDs {
+        FrameTimer,
+        StatsTimer
+    };
+    void wakeFrameTimer();
+    void frameTimerCallback();
+    bool needsCurveUpdate();
 
     PathProducer leftPathProducer, rightPathProducer;
+    juce::SharedResourcePointer<AnalyzerThread> analyzerThread;
 
-    bool shouldShowFFTAnlaysis = true;
+    bool shouldShowFFTAnlaysis = false;
+    bool analyzerSubscribed = false; // whether we're counted in the processor's analyzer subscribers
 };
 
 //==============================================================================
@@ -8,6 +8,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "FrequencyResponse.h"
 
 //==============================================================================
 SimpleEQAudioProcessor::SimpleEQAudioProcessor()
@@ -19,13 +20,29 @@ SimpleEQAudioProcessor::SimpleEQAudioProcessor()
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
-                       )
+                       ),
+       audibleBand(std::make_unique<FrequencyResponseEvaluator>())
+#else
+     : audibleBand(std::make_unique<FrequencyResponseEvaluator>())
 #endif
 {
+    const juce::Array<juce::AudioProcessorParameter*>& params = getParameters();
+    for (juce::AudioProcessorParameter* param : params) {
+        juce::AudioProcessorParameterWithID* paramWithID = dynamic_cast<juce::AudioProcessorParameterWithID*>(param);
+        parameterBandFlags.add(paramWithID != nullptr ? getBandFlag(paramWithID->paramID) : nullptr);
+        param->addListener(this);
+    }
+
+    startTimerHz(COEFFICIENT_UPDATE_RATE_HZ);
 }
 
 SimpleEQAudioProcessor::~SimpleEQAudioProcessor()
 {
+    stopTimer();
+    const juce::Array<juce::AudioProcessorParameter*>& params = getParameters();
+    for (juce::AudioProcessorParameter* param : params) {
+        param->removeListener(this);
+    }
 }
 
 //==============================================================================
@@ -63,7 +80,7 @@ bool SimpleEQAudioProcessor::isMidiEffect() const
 
 double SimpleEQAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLengthSeconds.get();
 }
 
 int SimpleEQAudioProcessor::getNumPrograms()
@@ -90,23 +107,72 @@ void SimpleEQAudioProcessor::changeProgramName (int index, const juce::String& n
 {
 }
 
+//==============================================================================
+// Can be called from any thread (including the audio thread during automation), so only flag the affected band here.
+// The band for each parameter index is looked up once in the constructor, so this never compares IDs.
+void SimpleEQAudioProcessor::parameterValueChanged(int parameterIndex, float newValue) {
+    if (!juce::isPositiveAndBelow(parameterIndex, parameterBandFlags.size())) {
+        return;
+    }
+
+    if (juce::Atomic<bool>* bandChanged = parameterBandFlags.getUnchecked(parameterIndex)) {
+        bandChanged->set(true);
+    }
+}
+
+juce::Atomic<bool>* SimpleEQAudioProcessor::getBandFlag(const juce::String& id) {
+    if (id == LOW_CUT_FREQ_NAME || id == LOW_CUT_SLOPE_NAME || id == LOW_CUT_BYPASS_NAME || id == LOW_CUT_MODE_NAME || id == LOW_CUT_DESIGN_NAME) {
+        return &lowCutChanged;
+    }
+    if (id == PEAK_FREQ_NAME || id == PEAK_GAIN_NAME || id == PEAK_QUALITY_NAME || id == PEAK_BYPASS_NAME || id == PEAK_MODE_NAME
+        || id == PEAK_DESIGN_NAME) {
+        return &peakChanged;
+    }
+    if (id == HIGH_CUT_FREQ_NAME || id == HIGH_CUT_SLOPE_NAME || id == HIGH_CUT_BYPASS_NAME || id == HIGH_CUT_MODE_NAME
+        || id == HIGH_CUT_DESIGN_NAME) {
+        return &highCutChanged;
+    }
+    return nullptr;
+}
+
+void SimpleEQAudioProcessor::setFlatBandTolerance(float toleranceDb) {
+    flatBandToleranceDb.set(toleranceDb);
+    // the cuts are checked against the tolerance as they're designed, so redesign and republish every band
+    lowCutChanged.set(true);
+    peakChanged.set(true);
+    highCutChanged.set(true);
+}
+
+void SimpleEQAudioProcessor::setSmoothing(double rampSeconds, int strideSamples) {
+    smoothingRampSeconds.set(juce::jmax(0.0, rampSeconds));
+    smoothingStrideSamples.set(juce::jmax(1, strideSamples));
+}
+
+void SimpleEQAudioProcessor::timerCallback() {
+    // coefficient design allocates, so it happens here on the message thread rather than in processBlock
+    updateChangedFilters();
+}
+
 //==============================================================================
 void SimpleEQAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    juce::dsp::ProcessSpec spec;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = 1;
-    spec.sampleRate = sampleRate;
-
-    // prepare the filters for each side
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
+    filterCascade.prepare(samplesPerBlock);
+    {
+        // the timer may be checking the cuts against the old grid
+        const juce::ScopedLock lock(designLock);
+        audibleBand->setAudibleBand(sampleRate);
+    }
 
+    // design with the new sample rate and pick it up straight away with no ramp, the audio thread is not running yet
     updateFilters();
+    applyPublishedCoefficients(true);
 
     leftChannelFifo.prepare(samplesPerBlock);
     rightChannelFifo.prepare(samplesPerBlock);
 
+    // loads from the old block size and sample rate don't compare with the new ones
+    realtimeStats.reset();
+
     // Oscillator for testing spectrum analyzer
     //osc.initialise([](float x) { return std::sin(x); });
     //spec.numChannels = getTotalNumOutputChannels();
@@ -127,12 +193,12 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
+    // Every channel runs through the same cascade with the same coefficients, so any layout from mono up to
+    // MAX_PROCESS_CHANNELS works, e.g. a whole 5.1 or 7.1.4 bus in one instance.
     // Some plugin hosts, such as certain GarageBand versions, will only
     // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    if (layouts.getMainOutputChannelSet().isDisabled()
+     || layouts.getMainOutputChannelSet().size() > FilterCascade::MaxChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -149,6 +215,9 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 void SimpleEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    RealtimeStats::AudioThreadScope audioThreadScope(realtimeStats);
+    juce::int64 blockStart = RealtimeStats::getTimestamp();
+
     int totalNumInputChannels  = getTotalNumInputChannels();
     int totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -161,26 +230,46 @@ void SimpleEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     for (int i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    updateFilters();
-
-    juce::dsp::AudioBlock<float> block(buffer);
+    // When rendering offline there is no realtime deadline and the message thread may not be running, so design inline.
+    // Otherwise the timer has already designed anything that changed and we only need to pick up the newest set.
+    if (isNonRealtime()) {
+        updateChangedFilters();
+    }
+    applyPublishedCoefficients(false);
 
     // Use with the oscillator to test the spectrum analysis
     //buffer.clear();
+    //juce::dsp::AudioBlock<float> block(buffer);
     //juce::dsp::ProcessContextReplacing<float> stereoContext(block);
     //osc.process(stereoContext);
 
-    juce::dsp::AudioBlock<float> leftBlock = block.getSingleChannelBlock(0);
-    juce::dsp::AudioBlock<float> rightBlock = block.getSingleChannelBlock(1);
-
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+    // Once the input is silent and the filters have rung out the output would be silent too, so skip the cascade.
+    // Anything still gliding keeps running so the ramp finishes on time.
+    if (!chainSmoother.isSmoothing()
+        && isSilent(buffer, totalNumInputChannels)
+        && filterCascade.isStateBelow(juce::Decibels::decibelsToGain(SILENCE_THRESHOLD_DB), totalNumInputChannels)) {
+        // start the next sound from exact zeros rather than whatever was left below the threshold
+        filterCascade.reset();
+        for (int i = 0; i < totalNumInputChannels; ++i) {
+            buffer.clear(i, 0, buffer.getNumSamples());
+        }
+    }
+    // every channel is processed together, one channel per SIMD lane
+    else if (chainSmoother.isSmoothing()) {
+        processSmoothed(buffer, totalNumInputChannels);
+    }
+    else {
+        filterCascade.process(buffer.getArrayOfWritePointers(), totalNumInputChannels, buffer.getNumSamples());
+    }
 
-    leftChain.process(leftContext);
-    rightChain.process(rightContext);
+    // the analyzer tap, skipped when nobody would ever read it
+    if (analyzerSubscribers.get() > 0) {
+        leftChannelFifo.update(buffer);
+        rightChannelFifo.update(buffer);
+    }
 
-    leftChannelFifo.update(buffer);
-    rightChannelFifo.update(buffer);
+    realtimeStats.addDenormals(filterCascade.countDenormalStates(totalNumInputChannels));
+    realtimeStats.blockFinished(blockStart, buffer.getNumSamples(), getSampleRate());
 }
 
 //==============================================================================
@@ -234,63 +323,455 @@ ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts) {
     settings.lowCutBypassed = apvts.getRawParameterValue(LOW_CUT_BYPASS_NAME)->load() > 0.5f; // If greater than .5, then true, else false
     settings.peakBypassed = apvts.getRawParameterValue(PEAK_BYPASS_NAME)->load() > 0.5f;
     settings.highCutBypassed = apvts.getRawParameterValue(HIGH_CUT_BYPASS_NAME)->load() > 0.5f;
+    settings.lowCutMode = static_cast<FilterMode>(apvts.getRawParameterValue(LOW_CUT_MODE_NAME)->load());
+    settings.peakMode = static_cast<FilterMode>(apvts.getRawParameterValue(PEAK_MODE_NAME)->load());
+    settings.highCutMode = static_cast<FilterMode>(apvts.getRawParameterValue(HIGH_CUT_MODE_NAME)->load());
+    settings.lowCutDesign = static_cast<FilterDesign>(apvts.getRawParameterValue(LOW_CUT_DESIGN_NAME)->load());
+    settings.peakDesign = static_cast<FilterDesign>(apvts.getRawParameterValue(PEAK_DESIGN_NAME)->load());
+    settings.highCutDesign = static_cast<FilterDesign>(apvts.getRawParameterValue(HIGH_CUT_DESIGN_NAME)->load());
 
     return settings;
 }
 
-Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate,
-                                                               chainSettings.peakFreq,
-                                                               chainSettings.peakQuality,
-                                                               juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels)); // helper function to convert the value of peak gain to decibels
+BiquadCoefficients<double> makeBiquadHighPass(double sampleRate, double frequency, double Q) {
+    double n = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    double nSquared = n * n;
+    double c1 = 1.0 / (1.0 + n / Q + nSquared);
+    return { c1, -2.0 * c1, c1, 2.0 * c1 * (nSquared - 1.0), c1 * (1.0 - n / Q + nSquared) };
+}
+
+BiquadCoefficients<double> makeBiquadLowPass(double sampleRate, double frequency, double Q) {
+    double n = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    double nSquared = n * n;
+    double c1 = 1.0 / (1.0 + n / Q + nSquared);
+    return { c1 * nSquared, 2.0 * c1 * nSquared, c1 * nSquared, 2.0 * c1 * (nSquared - 1.0), c1 * (1.0 - n / Q + nSquared) };
+}
+
+BiquadCoefficients<double> makeBiquadPeak(double sampleRate, double frequency, double Q, double gainFactor) {
+    double A = std::sqrt(gainFactor);
+    double omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+    double alpha = std::sin(omega) / (2.0 * Q);
+    double c2 = -2.0 * std::cos(omega);
+    double a0 = 1.0 + alpha / A;
+    return { (1.0 + alpha * A) / a0, c2 / a0, (1.0 - alpha * A) / a0, c2 / a0, (1.0 - alpha / A) / a0 };
+}
+
+// Denominator of the matched designs: the analog poles mapped with z = e^sT, for w0 in radians per sample
+static void makeMatchedPoles(double w0, double Q, double& a1, double& a2) {
+    double zeta = 1.0 / (2.0 * Q);
+    double r = std::exp(-zeta * w0);
+    if (zeta <= 1.0) {
+        a1 = -2.0 * r * std::cos(std::sqrt(1.0 - zeta * zeta) * w0); // complex pair
+    }
+    else {
+        a1 = -2.0 * r * std::cosh(std::sqrt(zeta * zeta - 1.0) * w0); // two real poles
+    }
+    a2 = r * r;
 }
 
+// |1 + a1 z^-1 + a2 z^-2|^2 at any w is A0 * phi0 + A1 * phi1 + A2 * phi2, with the phis only depending on w.
+// The matched designs work with these squared magnitudes, the same basis is used for the numerator's B0-B2.
+struct MatchedBasis {
+    double A0, A1, A2;
+    double phi0, phi1, phi2;
+
+    MatchedBasis(double w0, double a1, double a2) {
+        A0 = (1.0 + a1 + a2) * (1.0 + a1 + a2);
+        A1 = (1.0 - a1 + a2) * (1.0 - a1 + a2);
+        A2 = -4.0 * a2;
+
+        double s = std::sin(w0 / 2.0);
+        phi1 = s * s;
+        phi0 = 1.0 - phi1;
+        phi2 = 4.0 * phi0 * phi1;
+    }
+
+    double denominatorAtW0() const { return A0 * phi0 + A1 * phi1 + A2 * phi2; }
+};
 
-void SimpleEQAudioProcessor::updatePeakFilter(const ChainSettings& chainSettings) {
-    Coefficients peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
+BiquadCoefficients<double> makeMatchedHighPass(double sampleRate, double frequency, double Q) {
+    double w0 = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+    double a1, a2;
+    makeMatchedPoles(w0, Q, a1, a2);
+    MatchedBasis basis(w0, a1, a2);
 
-    leftChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
-    rightChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
+    // double zero at DC, scaled so the gain at w0 is the prototype's Q
+    double b0 = Q * std::sqrt(basis.denominatorAtW0()) / (4.0 * basis.phi1);
+    return { b0, -2.0 * b0, b0, a1, a2 };
+}
 
-    // link to the middle link in the chain (ChainPositions::Peak), the peak filter
-    updateCoefficients(leftChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    updateCoefficients(rightChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+BiquadCoefficients<double> makeMatchedLowPass(double sampleRate, double frequency, double Q) {
+    double w0 = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+    double a1, a2;
+    makeMatchedPoles(w0, Q, a1, a2);
+    MatchedBasis basis(w0, a1, a2);
+
+    // unity at DC and the prototype's Q at w0, with b2 = 0 leaving the response free to follow the prototype towards Nyquist
+    double R1 = basis.denominatorAtW0() * Q * Q;
+    double B0 = basis.A0;
+    double B1 = juce::jmax(0.0, (R1 - B0 * basis.phi0) / basis.phi1);
+    double b0 = 0.5 * (std::sqrt(B0) + std::sqrt(B1));
+    return { b0, std::sqrt(B0) - b0, 0.0, a1, a2 };
 }
 
-void updateCoefficients(Coefficients& old, const Coefficients& replacements) {
-    // the IIR::Coefficients helper functions return instances allocated on the heap, so they must be dereferenced
-    *old = *replacements;
+BiquadCoefficients<double> makeMatchedPeak(double sampleRate, double frequency, double Q, double gainFactor) {
+    // the same bell as makeBiquadPeak: poles at Q * A, zeros at Q / A, gainFactor at the centre
+    double A = std::sqrt(gainFactor);
+    double w0 = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+    double a1, a2;
+    makeMatchedPoles(w0, Q * A, a1, a2);
+    MatchedBasis basis(w0, a1, a2);
+
+    // unity at DC, gainFactor at w0, and the bell's width around w0
+    double gainSquared = gainFactor * gainFactor;
+    double R1 = basis.denominatorAtW0() * gainSquared;
+    double R2 = (-basis.A0 + basis.A1 + 4.0 * (basis.phi0 - basis.phi1) * basis.A2) * gainSquared;
+    double B0 = basis.A0;
+    double B2 = (R1 - R2 * basis.phi1 - B0) / (4.0 * basis.phi1 * basis.phi1);
+    double B1 = juce::jmax(0.0, R2 + B0 + 4.0 * (basis.phi1 - basis.phi0) * B2);
+
+    // back from squared magnitudes to a numerator with its zeros inside the unit circle
+    double W = 0.5 * (std::sqrt(B0) + std::sqrt(B1));
+    double b0 = 0.5 * (W + std::sqrt(juce::jmax(0.0, W * W + B2)));
+    double b1 = 0.5 * (std::sqrt(B0) - std::sqrt(B1));
+    double b2 = -B2 / (4.0 * b0);
+    return { b0, b1, b2, a1, a2 };
 }
 
-void SimpleEQAudioProcessor::updateLowCutFilter(const ChainSettings& chainSettings) {
-    auto lowCutCoefficients = makeLowCutFilter(chainSettings, getSampleRate());
-    CutFilter& leftLowCut = leftChain.get<ChainPositions::LowCut>();
-    CutFilter& rightLowCut = rightChain.get<ChainPositions::LowCut>();
+double getButterworthQ(int order, int section) {
+    return 1.0 / (2.0 * std::cos((2.0 * section + 1.0) * juce::MathConstants<double>::pi / (order * 2.0)));
+}
 
-    leftChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
-    rightChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
+// g is the prewarped cutoff and k the damping, m0-m2 pick the response (see SVFCoefficients)
+static SVFCoefficients makeSVFCoefficients(double g, double k, double m0, double m1, double m2) {
+    double a1 = 1.0 / (1.0 + g * (g + k));
+    double a2 = g * a1;
+    double a3 = g * a2;
+    return { (float)a1, (float)a2, (float)a3, (float)m0, (float)m1, (float)m2 };
+}
 
-    updateCutFilter(leftLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilter(rightLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
+static double getSVFCutoff(double sampleRate, double frequency) {
+    return std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
 }
 
-void SimpleEQAudioProcessor::updateHighCutFilter(const ChainSettings& chainSettings) {
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, getSampleRate());
-    CutFilter& leftHighCut = leftChain.get<ChainPositions::HighCut>();
-    CutFilter& rightHighCut = rightChain.get<ChainPositions::HighCut>();
+SVFCoefficients makeSVFHighPass(double sampleRate, double frequency, double Q) {
+    double k = 1.0 / Q;
+    return makeSVFCoefficients(getSVFCutoff(sampleRate, frequency), k, 1.0, -k, -1.0);
+}
 
-    leftChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
-    rightChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
+SVFCoefficients makeSVFLowPass(double sampleRate, double frequency, double Q) {
+    return makeSVFCoefficients(getSVFCutoff(sampleRate, frequency), 1.0 / Q, 0.0, 0.0, 1.0);
+}
 
-    updateCutFilter(leftHighCut, highCutCoefficients, chainSettings.highCutSlope);
-    updateCutFilter(rightHighCut, highCutCoefficients, chainSettings.highCutSlope);
+SVFCoefficients makeSVFPeak(double sampleRate, double frequency, double Q, double gainFactor) {
+    // same bell as the RBJ peak filter that IIR::Coefficients::makePeakFilter builds
+    double A = std::sqrt(gainFactor);
+    double k = 1.0 / (Q * A);
+    return makeSVFCoefficients(getSVFCutoff(sampleRate, frequency), k, 1.0, k * (A * A - 1.0), 0.0);
+}
+
+SVFCoefficients makeSVFFromBiquad(const BiquadCoefficients<double>& biquad) {
+    // The SVF's denominator is (1 + gk + g^2) + (2g^2 - 2) z^-1 + (1 - gk + g^2) z^-2, so g and k come straight from a1 and a2.
+    // Its input, band and low outputs are 1, g(1 - z^-2) and g^2(1 + z^-1)^2 over that, and m0-m2 mix them into the numerator.
+    double g = std::sqrt((1.0 + biquad.a1 + biquad.a2) / (1.0 - biquad.a1 + biquad.a2));
+    double d = 4.0 / (1.0 - biquad.a1 + biquad.a2); // 1 + gk + g^2
+    double k = (1.0 - biquad.a2) * d / (2.0 * g);
+
+    double m0 = (biquad.b0 - biquad.b1 + biquad.b2) * d / 4.0;
+    double m2 = (biquad.b1 * d - m0 * (2.0 * g * g - 2.0)) / (2.0 * g * g);
+    double m1 = (biquad.b0 - biquad.b2) * d / (2.0 * g) - m0 * k;
+    return makeSVFCoefficients(g, k, m0, m1, m2);
+}
+
+void designLowCut(ChainCoefficients& chainCoefficients, const ChainSettings& chainSettings, double sampleRate) {
+    // Butterworth high pass made of 1-4 second order sections, the same design as juce::dsp::FilterDesign's Butterworth but in double
+    int order = 2 * (chainSettings.lowCutSlope + 1);
+    for (int i = 0; i < order / 2; ++i) {
+        double Q = getButterworthQ(order, i);
+        if (chainSettings.lowCutDesign == Design_Matched) {
+            chainCoefficients.lowCut[i].biquad = makeMatchedHighPass(sampleRate, chainSettings.lowCutFreq, Q);
+            chainCoefficients.lowCut[i].svf = makeSVFFromBiquad(chainCoefficients.lowCut[i].biquad);
+        }
+        else {
+            chainCoefficients.lowCut[i].biquad = makeBiquadHighPass(sampleRate, chainSettings.lowCutFreq, Q);
+            chainCoefficients.lowCut[i].svf = makeSVFHighPass(sampleRate, chainSettings.lowCutFreq, Q);
+        }
+    }
+}
+
+void designPeak(ChainCoefficients& chainCoefficients, const ChainSettings& chainSettings, double sampleRate) {
+    double gainFactor = juce::Decibels::decibelsToGain((double)chainSettings.peakGainInDecibels);
+    if (chainSettings.peakDesign == Design_Matched) {
+        chainCoefficients.peak.biquad = makeMatchedPeak(sampleRate, chainSettings.peakFreq, chainSettings.peakQuality, gainFactor);
+        chainCoefficients.peak.svf = makeSVFFromBiquad(chainCoefficients.peak.biquad);
+    }
+    else {
+        chainCoefficients.peak.biquad = makeBiquadPeak(sampleRate, chainSettings.peakFreq, chainSettings.peakQuality, gainFactor);
+        chainCoefficients.peak.svf = makeSVFPeak(sampleRate, chainSettings.peakFreq, chainSettings.peakQuality, gainFactor);
+    }
+}
+
+void designHighCut(ChainCoefficients& chainCoefficients, const ChainSettings& chainSettings, double sampleRate) {
+    // Butterworth low pass made of 1-4 second order sections, the same design as juce::dsp::FilterDesign's Butterworth but in double
+    int order = 2 * (chainSettings.highCutSlope + 1);
+    for (int i = 0; i < order / 2; ++i) {
+        double Q = getButterworthQ(order, i);
+        if (chainSettings.highCutDesign == Design_Matched) {
+            chainCoefficients.highCut[i].biquad = makeMatchedLowPass(sampleRate, chainSettings.highCutFreq, Q);
+            chainCoefficients.highCut[i].svf = makeSVFFromBiquad(chainCoefficients.highCut[i].biquad);
+        }
+        else {
+            chainCoefficients.highCut[i].biquad = makeBiquadLowPass(sampleRate, chainSettings.highCutFreq, Q);
+            chainCoefficients.highCut[i].svf = makeSVFLowPass(sampleRate, chainSettings.highCutFreq, Q);
+        }
+    }
+}
+
+// A cut's active stages, checked over the audible band as they were designed
+static bool isCutTransparent(const std::array<CascadeSection, CUT_FILTER_STAGES>& sections, Slope slope,
+                             const FrequencyResponseEvaluator& audibleBand, float toleranceDb) {
+    std::array<BiquadCoefficients<double>, CUT_FILTER_STAGES> stages;
+    int numStages = getNumActiveStages(slope, false);
+    for (int i = 0; i < numStages; ++i) {
+        stages[(size_t)i] = sections[(size_t)i].biquad;
+    }
+    return audibleBand.getNumFrequencies() > 0 && audibleBand.isWithinDb(stages.data(), numStages, toleranceDb);
+}
+
+ChainSettings findTransparentCuts(ChainSettings chainSettings, const ChainCoefficients& chainCoefficients,
+                                  const FrequencyResponseEvaluator& audibleBand, float toleranceDb) {
+    // a cut still takes 3dB off at its corner, so one at the end of its range only counts once a tolerance that wide allows it
+    chainSettings.lowCutTransparent = toleranceDb >= 0.f
+                                      && isCutTransparent(chainCoefficients.lowCut, chainSettings.lowCutSlope, audibleBand, toleranceDb);
+    chainSettings.highCutTransparent = toleranceDb >= 0.f
+                                       && isCutTransparent(chainCoefficients.highCut, chainSettings.highCutSlope, audibleBand, toleranceDb);
+    return chainSettings;
+}
+
+ChainSettings bypassTransparentBands(ChainSettings chainSettings, float toleranceDb) {
+    if (toleranceDb < 0.f) {
+        return chainSettings;
+    }
+
+    // a 0dB peak designs to b == a, and a bell never strays further from 0dB than its gain
+    if (std::abs(chainSettings.peakGainInDecibels) <= toleranceDb) {
+        chainSettings.peakBypassed = true;
+    }
+    if (chainSettings.lowCutTransparent) {
+        chainSettings.lowCutBypassed = true;
+    }
+    if (chainSettings.highCutTransparent) {
+        chainSettings.highCutBypassed = true;
+    }
+    return chainSettings;
+}
+
+int getNumActiveStages(Slope slope, bool bypassed) {
+    if (bypassed) {
+        return 0;
+    }
+
+    int numStages = 0;
+    switch (slope)
+    {
+    case Slope_48:
+        ++numStages;
+        [[fallthrough]];
+    case Slope_36:
+        ++numStages;
+        [[fallthrough]];
+    case Slope_24:
+        ++numStages;
+        [[fallthrough]];
+    case Slope_12:
+        ++numStages;
+        break;
+    }
+    return numStages;
+}
+
+// Slowest decay of one section: the impulse response shrinks by the largest pole radius every sample
+static double getSectionTailSamples(const BiquadCoefficients<double>& biquad, double maxSamples) {
+    // poles are the roots of z^2 + a1 z + a2
+    double discriminant = biquad.a1 * biquad.a1 - 4.0 * biquad.a2;
+    double radius = 0.0;
+    if (discriminant < 0.0) {
+        radius = std::sqrt(biquad.a2); // complex pair, |p|^2 = a2
+    }
+    else {
+        double root = std::sqrt(discriminant);
+        radius = juce::jmax(std::abs(-biquad.a1 + root), std::abs(-biquad.a1 - root)) * 0.5;
+    }
+
+    if (radius >= 1.0) {
+        return maxSamples; // unstable or an integrator, it never decays
+    }
+    if (radius <= 0.0) {
+        return 2.0; // no feedback, just the two delays
+    }
+    return juce::jmin(maxSamples, std::log(juce::Decibels::decibelsToGain(TAIL_DECAY_DB, -1000.0)) / std::log(radius));
+}
+
+double estimateTailSamples(const ChainCoefficients& chainCoefficients, double sampleRate) {
+    const ChainSettings& settings = chainCoefficients.settings;
+    double maxSamples = MAX_TAIL_SECONDS * sampleRate;
+    double tailSamples = 0.0;
+
+    int numLowCutStages = getNumActiveStages(settings.lowCutSlope, settings.lowCutBypassed);
+    for (int i = 0; i < numLowCutStages; ++i) {
+        tailSamples += getSectionTailSamples(chainCoefficients.lowCut[i].biquad, maxSamples);
+    }
+    if (!settings.peakBypassed) {
+        tailSamples += getSectionTailSamples(chainCoefficients.peak.biquad, maxSamples);
+    }
+    int numHighCutStages = getNumActiveStages(settings.highCutSlope, settings.highCutBypassed);
+    for (int i = 0; i < numHighCutStages; ++i) {
+        tailSamples += getSectionTailSamples(chainCoefficients.highCut[i].biquad, maxSamples);
+    }
+    return juce::jmin(maxSamples, tailSamples);
 }
 
 void SimpleEQAudioProcessor::updateFilters() {
+    // force every band to be redesigned, e.g. when the sample rate or the whole state has changed
+    lowCutChanged.set(true);
+    peakChanged.set(true);
+    highCutChanged.set(true);
+    updateChangedFilters();
+}
+
+void SimpleEQAudioProcessor::updateChangedFilters() {
+    // The timer, prepareToPlay and setStateInformation may all end up in here, but only one of them can be the writer at a time
+    RealtimeStats::noteLock();
+    const juce::ScopedLock lock(designLock);
+
+    // clear each flag before reading the parameters, a change that lands after the read will set it again for the next tick
+    bool lowCutDirty = lowCutChanged.compareAndSetBool(false, true);
+    bool peakDirty = peakChanged.compareAndSetBool(false, true);
+    bool highCutDirty = highCutChanged.compareAndSetBool(false, true);
+
+    if (!lowCutDirty && !peakDirty && !highCutDirty) {
+        return;
+    }
+
+    double sampleRate = getSampleRate();
+    if (sampleRate <= 0.0) {
+        // not prepared yet, prepareToPlay will design everything once we know the sample rate
+        lowCutChanged.set(true);
+        peakChanged.set(true);
+        highCutChanged.set(true);
+        return;
+    }
+
     ChainSettings chainSettings = getChainSettings(apvts);
-    updateLowCutFilter(chainSettings);
-    updatePeakFilter(chainSettings);
-    updateHighCutFilter(chainSettings);
+    if (lowCutDirty) {
+        designLowCut(designedCoefficients, chainSettings, sampleRate);
+    }
+    if (peakDirty) {
+        designPeak(designedCoefficients, chainSettings, sampleRate);
+    }
+    if (highCutDirty) {
+        designHighCut(designedCoefficients, chainSettings, sampleRate);
+    }
+    // the cuts are checked here, once per design, so the audio thread only has to read the flags
+    float toleranceDb = flatBandToleranceDb.get();
+    designedCoefficients.settings = findTransparentCuts(chainSettings, designedCoefficients, *audibleBand, toleranceDb);
+    // only the bands that will actually run ring on after the input stops
+    ChainCoefficients runningCoefficients = designedCoefficients;
+    runningCoefficients.settings = bypassTransparentBands(designedCoefficients.settings, toleranceDb);
+    tailLengthSeconds.set(estimateTailSamples(runningCoefficients, sampleRate) / sampleRate);
+
+    coefficientBuffer.getWriteBuffer() = designedCoefficients;
+    coefficientBuffer.publish();
+}
+
+void SimpleEQAudioProcessor::applyPublishedCoefficients(bool jumpToTargets) {
+    // only swaps an index in the triple buffer, then copies the coefficients into the cascade
+    if (!coefficientBuffer.acquire()) {
+        return;
+    }
+
+    const ChainCoefficients& chainCoefficients = coefficientBuffer.getReadBuffer();
+    if (jumpToTargets) {
+        chainSmoother.reset(getSampleRate(), smoothingRampSeconds.get(), chainCoefficients.settings);
+    }
+    else {
+        chainSmoother.setTargets(chainCoefficients.settings);
+    }
+
+    // A band that is still gliding is redesigned every stride by processSmoothed, so only take the published design for settled bands
+    applyBands(chainCoefficients,
+               chainCoefficients.settings,
+               !chainSmoother.isLowCutSmoothing(),
+               !chainSmoother.isPeakSmoothing(),
+               !chainSmoother.isHighCutSmoothing());
+}
+
+void SimpleEQAudioProcessor::applyBands(const ChainCoefficients& chainCoefficients, const ChainSettings& designSettings, bool lowCut, bool peak, bool highCut) {
+    // the peak is checked against the ramped gain while gliding, so one easing down to 0dB only drops out once it gets there
+    ChainSettings chainSettings = bypassTransparentBands(designSettings, flatBandToleranceDb.get());
+    if (lowCut) {
+        filterCascade.setLowCut(chainCoefficients.lowCut,
+                                getNumActiveStages(chainSettings.lowCutSlope, chainSettings.lowCutBypassed),
+                                chainSettings.lowCutMode);
+    }
+    if (peak) {
+        filterCascade.setPeak(chainCoefficients.peak, !chainSettings.peakBypassed, chainSettings.peakMode);
+    }
+    if (highCut) {
+        filterCascade.setHighCut(chainCoefficients.highCut,
+                                 getNumActiveStages(chainSettings.highCutSlope, chainSettings.highCutBypassed),
+                                 chainSettings.highCutMode);
+    }
+}
+
+// Runs the block in short strides, redesigning any band that is still gliding before each one.
+// The designs are closed form and allocation free, so this is safe on the audio thread.
+void SimpleEQAudioProcessor::processSmoothed(juce::AudioBuffer<float>& buffer, int numChannels) {
+    numChannels = juce::jmin(numChannels, FilterCascade::MaxChannels);
+    std::array<float*, FilterCascade::MaxChannels> channels;
+    double sampleRate = getSampleRate();
+    int numSamples = buffer.getNumSamples();
+    int strideSamples = smoothingStrideSamples.get();
+
+    for (int start = 0; start < numSamples; start += strideSamples) {
+        int strideSize = juce::jmin(strideSamples, numSamples - start);
+
+        bool lowCutMoving = chainSmoother.isLowCutSmoothing();
+        bool peakMoving = chainSmoother.isPeakSmoothing();
+        bool highCutMoving = chainSmoother.isHighCutSmoothing();
+        ChainSettings chainSettings = chainSmoother.skip(strideSize);
+
+        if (lowCutMoving) {
+            designLowCut(smoothedCoefficients, chainSettings, sampleRate);
+        }
+        if (peakMoving) {
+            designPeak(smoothedCoefficients, chainSettings, sampleRate);
+        }
+        if (highCutMoving) {
+            designHighCut(smoothedCoefficients, chainSettings, sampleRate);
+        }
+        // the published transparency describes the target design, so a gliding cut only drops out on the stride its ramp arrives
+        chainSettings.lowCutTransparent = chainSettings.lowCutTransparent && !chainSmoother.isLowCutSmoothing();
+        chainSettings.highCutTransparent = chainSettings.highCutTransparent && !chainSmoother.isHighCutSmoothing();
+        applyBands(smoothedCoefficients, chainSettings, lowCutMoving, peakMoving, highCutMoving);
+
+        for (int c = 0; c < numChannels; ++c) {
+            channels[c] = buffer.getWritePointer(c, start);
+        }
+        filterCascade.process(channels.data(), numChannels, strideSize);
+    }
+}
+
+// Every channel's peak is below SILENCE_THRESHOLD_DB. One read of the block, far cheaper than running the cascade over it.
+bool SimpleEQAudioProcessor::isSilent(const juce::AudioBuffer<float>& buffer, int numChannels) {
+    float threshold = juce::Decibels::decibelsToGain(SILENCE_THRESHOLD_DB);
+    for (int c = 0; c < numChannels; ++c) {
+        juce::Range<float> range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(c), buffer.getNumSamples());
+        if (-range.getStart() >= threshold || range.getEnd() >= threshold) {
+            return false;
+        }
+    }
+    return true;
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout SimpleEQAudioProcessor::createParameterLayout() {
@@ -338,6 +819,22 @@ juce::AudioProcessorValueTreeState::ParameterLayout SimpleEQAudioProcessor::crea
     layout.add(std::make_unique<juce::AudioParameterBool>(HIGH_CUT_BYPASS_NAME, HIGH_CUT_BYPASS_NAME, BYPASS_DEFAULT));
     layout.add(std::make_unique<juce::AudioParameterBool>(ANALYZER_ENABLED_NAME, ANALYZER_ENABLED_NAME, ENABLED_DEFAULT));
 
+    // Everything below was added after the original parameters above. New parameters only ever go on the end, in the order they
+    // were added, so hosts that address parameters by index keep finding the same ones in older sessions and automation.
+
+    // precision/topology each band is run with
+    layout.add(std::make_unique<juce::AudioParameterChoice>(LOW_CUT_MODE_NAME, LOW_CUT_MODE_NAME, FILTER_MODE_CHOICES, MODE_DEFAULT_POS));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(PEAK_MODE_NAME, PEAK_MODE_NAME, FILTER_MODE_CHOICES, MODE_DEFAULT_POS));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(HIGH_CUT_MODE_NAME, HIGH_CUT_MODE_NAME, FILTER_MODE_CHOICES, MODE_DEFAULT_POS));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(ANALYZER_OVERLAP_NAME, ANALYZER_OVERLAP_NAME, ANALYZER_OVERLAP_CHOICES, ANALYZER_OVERLAP_DEFAULT_POS));
+    layout.add(std::make_unique<juce::AudioParameterBool>(ANALYZER_LATEST_FRAME_ONLY_NAME, ANALYZER_LATEST_FRAME_ONLY_NAME, ANALYZER_LATEST_FRAME_ONLY_DEFAULT));
+
+    // how each band's analog prototype is turned into coefficients
+    layout.add(std::make_unique<juce::AudioParameterChoice>(LOW_CUT_DESIGN_NAME, LOW_CUT_DESIGN_NAME, FILTER_DESIGN_CHOICES, DESIGN_DEFAULT_POS));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(PEAK_DESIGN_NAME, PEAK_DESIGN_NAME, FILTER_DESIGN_CHOICES, DESIGN_DEFAULT_POS));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(HIGH_CUT_DESIGN_NAME, HIGH_CUT_DESIGN_NAME, FILTER_DESIGN_CHOICES, DESIGN_DEFAULT_POS));
+
     return layout;
 }
 
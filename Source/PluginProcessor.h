@@ -11,23 +11,15 @@
 #include <JuceHeader.h>
 #include <array>
 #include "Constants.h"
+#include "FilterCascade.h"
+#include "RealtimeStats.h"
+
+class FrequencyResponseEvaluator;
 
 // Note: this struct was not covered in the course, just had to copy it
 // Used by GUI thread to process blocks
 template<typename T>
 struct Fifo {
-    void prepare(int numChannels, int numSamples) {
-        static_assert(std::is_same_v<T, juce::AudioBuffer<float>>, "prepare(numChannels, numSamples) should only be used when the Fifo is holding juce::AudioBuffer<float>");
-        for (T& buffer : buffers) {
-            buffer.setSize(numChannels, 
-                           numSamples, 
-                           false,       //clear everything
-                           true,        //including the extra space
-                           true);       //avoid reallocating if you can
-            buffer.clear();
-        }
-    }
-
     void prepare(size_t numElements) {
         static_assert(std::is_same_v<T, std::vector<float>>, "prepare(numElements) should only be used when the Fifo is holding std::vector<float>");
         for (T& buffer : buffers) {
@@ -64,71 +56,126 @@ private:
     std::array<T, Capacity> buffers;
     juce::AbstractFifo fifo{ Capacity };
 };
+
+// Lock-free single producer, single consumer triple buffer.
+// The writer fills getWriteBuffer() and calls publish(), the reader calls acquire() and then uses getReadBuffer().
+// All three slots are allocated up front, so neither side ever allocates or blocks; the reader only ever swaps an index.
+template<typename T>
+struct TripleBuffer {
+    // Writer side
+    T& getWriteBuffer() { return buffers[backIndex]; }
+
+    void publish() {
+        // hand the freshly written slot to the middle and take back whatever was there
+        int previous = middle.exchange(backIndex | FreshFlag);
+        backIndex = previous & IndexMask;
+    }
+
+    // Reader side, returns true if a newer value was published since the last call
+    bool acquire() {
+        if ((middle.get() & FreshFlag) == 0) {
+            return false;
+        }
+
+        int previous = middle.exchange(frontIndex);
+        frontIndex = previous & IndexMask;
+        return true;
+    }
+
+    const T& getReadBuffer() const { return buffers[frontIndex]; }
+
+private:
+    static constexpr int IndexMask = 3;
+    static constexpr int FreshFlag = 4;
+
+    std::array<T, 3> buffers;
+    int backIndex = 0;
+    juce::Atomic<int> middle{ 1 };
+    int frontIndex = 2;
+};
+
 enum Channel {
     Right, // effectively 0
     Left // effectively 1
 };
 
-// Note: this struct was not covered in the course, just had to copy it
-// Collect the buffers into blocks of fixed sizes using this class
+// Note: this struct was not covered in the course, it started as a copy and has since been reworked
+// Lock-free single producer, single consumer ring of samples for one channel of the analyzer tap.
 // According to the course:
     // Host Buffer has x samples -> SingleChannelSampleFifo -> Fixed size Blocks -> Fast Fourier Transform DataGenerator ->
     // FastFourierTransform DataBlocks -> PathProducer -> Juce::Path -> which is consumed by the GUI to draw the Spectrum Analysis Curve
+// The audio thread copies each host buffer straight into the ring, the analyzer copies straight out of it into its FFT window,
+// so there are no intermediate buffers and no limit on how many host blocks can be waiting.
 template<typename BlockType>
 struct SingleChannelSampleFifo {
     SingleChannelSampleFifo(Channel ch) : channelToUse(ch) {
         prepared.set(false);
     }
 
+    // Audio thread: if the analyzer has fallen so far behind that the ring is full, the part of the block that doesn't fit is dropped.
+    // A mono bus has no second channel, so there both analyzer channels show the one channel there is.
     void update(const BlockType& buffer) {
         jassert(prepared.get());
-        jassert(buffer.getNumChannels() > channelToUse);
+        if (buffer.getNumChannels() == 0) {
+            return;
+        }
         // auto is ok here because we don't nessecarily know the type of buffer (BlockType is a template)
-        auto* channelPtr = buffer.getReadPointer(channelToUse);
+        auto* channelPtr = buffer.getReadPointer(juce::jmin((int)channelToUse, buffer.getNumChannels() - 1));
 
-        for (int i = 0; i < buffer.getNumSamples(); ++i) {
-            pushNextSampleIntoFifo(channelPtr[i]);
+        juce::AbstractFifo::ScopedWrite write = fifo.write(buffer.getNumSamples());
+        if (write.blockSize1 > 0) {
+            juce::FloatVectorOperations::copy(ring.get() + write.startIndex1, channelPtr, write.blockSize1);
+        }
+        if (write.blockSize2 > 0) {
+            juce::FloatVectorOperations::copy(ring.get() + write.startIndex2, channelPtr + write.blockSize1, write.blockSize2);
         }
     }
 
+    // Reallocates the ring, so it waits for the reader to let go of getReaderLock first.
+    // The audio thread is never running during prepareToPlay, so update() doesn't need the lock.
     void prepare(int bufferSize) {
+        const juce::ScopedLock lock(readerLock);
         prepared.set(false);
         size.set(bufferSize);
 
-        bufferToFill.setSize(1,             //channel
-                             bufferSize,    //num samples
-                             false,         //keepExistingContent
-                             true,          //clear extra space
-                             true);         //avoid reallocating
-        audioBufferFifo.prepare(1, bufferSize);
-        fifoIndex = 0;
+        // room for a full analysis window plus plenty of host blocks arriving between two analyzer ticks
+        int capacity = juce::jmax(ANALYZER_RING_MIN_SAMPLES, 4 * bufferSize) + 1; // an AbstractFifo holds one less than its size
+        ring.calloc((size_t)capacity);
+        fifo.setTotalSize(capacity);
         prepared.set(true);
     }
     //==============================================================================
-    int getNumcompleteBuffersAvailable() const { return audioBufferFifo.getNumAvailableForReading(); }
+    // Reader side. The reader holds getReaderLock for as long as it uses any of these, and checks isPrepared once it has it,
+    // so prepare can't free or resize the ring underneath it.
+    const juce::CriticalSection& getReaderLock() const { return readerLock; }
+    int getNumSamplesAvailable() const { return fifo.getNumReady(); }
     bool isPrepared() const { return prepared.get(); }
+    // The host buffer size given to prepare
     int getSize() const { return size.get(); }
-    //==============================================================================
-    bool getAudioBuffer(BlockType& buf) { return audioBufferFifo.pull(buf); }
+
+    // Copies the oldest numSamples waiting in the ring to destination and frees their space for the audio thread
+    void readSamples(float* destination, int numSamples) {
+        juce::AbstractFifo::ScopedRead read = fifo.read(numSamples);
+        if (read.blockSize1 > 0) {
+            juce::FloatVectorOperations::copy(destination, ring.get() + read.startIndex1, read.blockSize1);
+        }
+        if (read.blockSize2 > 0) {
+            juce::FloatVectorOperations::copy(destination + read.blockSize1, ring.get() + read.startIndex2, read.blockSize2);
+        }
+    }
+
+    // Throws away the oldest numSamples, for when the reader only cares about the most recent audio
+    void skipSamples(int numSamples) {
+        fifo.finishedRead(juce::jmin(numSamples, fifo.getNumReady()));
+    }
 
 private:
     Channel channelToUse;
-    int fifoIndex = 0;
-    Fifo<BlockType> audioBufferFifo;
-    BlockType bufferToFill;
+    juce::HeapBlock<float> ring;
+    juce::AbstractFifo fifo{ 1 };
+    juce::CriticalSection readerLock;
     juce::Atomic<bool> prepared = false;
     juce::Atomic<int> size = 0;
-
-    void pushNextSampleIntoFifo(float sample) {
-        if (fifoIndex == bufferToFill.getNumSamples()) {
-            bool ok = audioBufferFifo.push(bufferToFill);
-            juce::ignoreUnused(ok);
-            fifoIndex = 0;
-        }
-
-        bufferToFill.setSample(0, fifoIndex, sample);
-        ++fifoIndex;
-    }
 };
 
 enum Slope {
@@ -138,78 +185,146 @@ enum Slope {
     Slope_48
 };
 
+// How each band's analog prototype is turned into a biquad.
+// Bilinear is the classic RBJ/JUCE design, which cramps bells and cuts towards Nyquist at 44.1/48KHz.
+// Matched follows the analog magnitude up to Nyquist instead, for the same per sample cost.
+enum FilterDesign {
+    Design_Bilinear,
+    Design_Matched
+};
+
 struct ChainSettings {
     float peakFreq{ 0 }, peakGainInDecibels{ 0 }, peakQuality{ 1.f };
     float lowCutFreq{ 0 }, highCutFreq{ 0 };
     Slope lowCutSlope{ Slope::Slope_12 }, highCutSlope{ Slope::Slope_12 };
     bool lowCutBypassed{ false }, peakBypassed{ false }, highCutBypassed{ false };
+    FilterMode lowCutMode{ Mode_FloatTDF2 }, peakMode{ Mode_FloatTDF2 }, highCutMode{ Mode_FloatTDF2 };
+    FilterDesign lowCutDesign{ Design_Bilinear }, peakDesign{ Design_Bilinear }, highCutDesign{ Design_Bilinear };
+    // worked out on the design side by findTransparentCuts, for the designs these settings describe
+    bool lowCutTransparent{ false }, highCutTransparent{ false };
 };
 
 ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
 
-// Use a bunch of aliases here to shorten down all the JUCE namespaces
-using Filter = juce::dsp::IIR::Filter<float>;
-using Coefficients = Filter::CoefficientsPtr;
-// each fiter type has a response type of 12db/Oct. If we want a filter to do 48db/Oct, then we need to chain together 4 filters.
-// This will require using a dsp processor chain to process all the audio as if it were a 48db/Oct filter.
-using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
-// First CutFilter is lowpass, mid filter is the bandpass (peak filter), last filter is the highpass
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
-
-enum ChainPositions {
-    LowCut,
-    Peak,
-    HighCut
+// A fully designed set of coefficients for every band, this is what gets handed from the message thread to the audio thread
+struct ChainCoefficients {
+    ChainSettings settings; // the parameter values the sections were designed from, the audio thread smooths towards these
+    std::array<CascadeSection, CUT_FILTER_STAGES> lowCut;
+    CascadeSection peak;
+    std::array<CascadeSection, CUT_FILTER_STAGES> highCut;
 };
 
-void updateCoefficients(Coefficients& old, const Coefficients& replacements);
-
-Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRate);
-
-// I think the template is just being used to avoid typing out long typenames, but I'm not quite sure
-template<int Index, typename ChainType, typename CoefficientType>
-void update(ChainType& chain, const CoefficientType& coefficients) {
-    // May need to call template before each of the methods (i.e. chain.template get<>) (the video example needed to do this)
-    updateCoefficients(chain.template get<Index>().coefficients, coefficients[Index]);
-    chain.template setBypassed<Index>(false);
-}
-
-template<typename ChainType, typename CoefficientType>
-void updateCutFilter(ChainType& chain, const CoefficientType& cutCoefficients, const Slope& slope) {
-    chain.setBypassed<0>(true);
-    chain.setBypassed<1>(true);
-    chain.setBypassed<2>(true);
-    chain.setBypassed<3>(true);
-
-    switch (slope)
-    {
-    case Slope_48:
-        update<3>(chain, cutCoefficients);
-    case Slope_36:
-        update<2>(chain, cutCoefficients);
-    case Slope_24:
-        update<1>(chain, cutCoefficients);
-    case Slope_12:
-        update<0>(chain, cutCoefficients);
-        break;
+// Ramps the continuous parameters of each band (frequencies, gain and Q) towards the latest published settings,
+// so automation and knob moves glide instead of zippering at block boundaries. Only used on the audio thread.
+struct ChainSmoother {
+    void reset(double sampleRate, double rampSeconds, const ChainSettings& settings) {
+        targetSettings = settings;
+        lowCutFreq.setCurrentAndTargetValue(settings.lowCutFreq);
+        highCutFreq.setCurrentAndTargetValue(settings.highCutFreq);
+        peakFreq.setCurrentAndTargetValue(settings.peakFreq);
+        peakGain.setCurrentAndTargetValue(settings.peakGainInDecibels);
+        peakQuality.setCurrentAndTargetValue(settings.peakQuality);
+
+        lowCutFreq.reset(sampleRate, rampSeconds);
+        highCutFreq.reset(sampleRate, rampSeconds);
+        peakFreq.reset(sampleRate, rampSeconds);
+        peakGain.reset(sampleRate, rampSeconds);
+        peakQuality.reset(sampleRate, rampSeconds);
     }
-}
-
-inline auto makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq,
-                                                                                       sampleRate,
-                                                                                       2 * (chainSettings.lowCutSlope + 1));
-}
-
-inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq,
-                                                                                      sampleRate,
-                                                                                      2 * (chainSettings.highCutSlope + 1));
-}
+
+    void setTargets(const ChainSettings& settings) {
+        targetSettings = settings;
+        lowCutFreq.setTargetValue(settings.lowCutFreq);
+        highCutFreq.setTargetValue(settings.highCutFreq);
+        peakFreq.setTargetValue(settings.peakFreq);
+        peakGain.setTargetValue(settings.peakGainInDecibels);
+        peakQuality.setTargetValue(settings.peakQuality);
+    }
+
+    bool isLowCutSmoothing() const { return lowCutFreq.isSmoothing(); }
+    bool isPeakSmoothing() const { return peakFreq.isSmoothing() || peakGain.isSmoothing() || peakQuality.isSmoothing(); }
+    bool isHighCutSmoothing() const { return highCutFreq.isSmoothing(); }
+    bool isSmoothing() const { return isLowCutSmoothing() || isPeakSmoothing() || isHighCutSmoothing(); }
+
+    // Moves every ramp on by numSamples and returns the target settings with the continuous values swapped for the ramped ones
+    // at the middle of those samples, see skipToMiddle
+    ChainSettings skip(int numSamples) {
+        ChainSettings settings = targetSettings;
+        settings.lowCutFreq = skipToMiddle(lowCutFreq, numSamples);
+        settings.highCutFreq = skipToMiddle(highCutFreq, numSamples);
+        settings.peakFreq = skipToMiddle(peakFreq, numSamples);
+        settings.peakGainInDecibels = skipToMiddle(peakGain, numSamples);
+        settings.peakQuality = skipToMiddle(peakQuality, numSamples);
+        return settings;
+    }
+
+private:
+    // The stride is filtered with the value from the middle of its part of the ramp, rather than the value it ends on,
+    // so the designs don't run a whole stride ahead of the ramp. The stride a ramp arrives on takes the target instead,
+    // so the band settles on exactly the published design.
+    template<typename SmoothedValueType>
+    static float skipToMiddle(SmoothedValueType& value, int numSamples) {
+        float middle = value.skip(numSamples / 2);
+        float end = value.skip(numSamples - numSamples / 2);
+        return value.isSmoothing() ? middle : end;
+    }
+
+    ChainSettings targetSettings;
+    // frequencies and Q are perceived logarithmically, so ramp them multiplicatively, gain is already in dB
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> lowCutFreq, highCutFreq, peakFreq, peakQuality;
+    juce::SmoothedValue<float> peakGain;
+};
+
+// Same designs as IIR::Coefficients::makeHighPass, makeLowPass and makePeakFilter, but returned by value so they never allocate
+BiquadCoefficients<double> makeBiquadHighPass(double sampleRate, double frequency, double Q);
+BiquadCoefficients<double> makeBiquadLowPass(double sampleRate, double frequency, double Q);
+BiquadCoefficients<double> makeBiquadPeak(double sampleRate, double frequency, double Q, double gainFactor);
+
+// Martin Vicanek's matched second order designs ("Matched Second Order Digital Filters", 2016).
+// The poles sit exactly where the analog prototype's map to (z = e^sT) and the numerator is solved from the prototype's
+// magnitude at DC, Nyquist and the cutoff/centre, so the response stays close to analog right up to Nyquist without oversampling.
+// The peak uses the same analog bell as makeBiquadPeak, so at 0dB it is still exactly b == a.
+BiquadCoefficients<double> makeMatchedHighPass(double sampleRate, double frequency, double Q);
+BiquadCoefficients<double> makeMatchedLowPass(double sampleRate, double frequency, double Q);
+BiquadCoefficients<double> makeMatchedPeak(double sampleRate, double frequency, double Q, double gainFactor);
+
+// Q of one second order section of an even order Butterworth filter, the same values juce::dsp::FilterDesign uses
+double getButterworthQ(int order, int section);
+
+// SVF equivalents of IIR::Coefficients::makeHighPass, makeLowPass and makePeakFilter
+SVFCoefficients makeSVFHighPass(double sampleRate, double frequency, double Q);
+SVFCoefficients makeSVFLowPass(double sampleRate, double frequency, double Q);
+SVFCoefficients makeSVFPeak(double sampleRate, double frequency, double Q, double gainFactor);
+// SVF with exactly the same transfer function as any stable biquad, used for the designs that don't come from a prewarped cutoff
+SVFCoefficients makeSVFFromBiquad(const BiquadCoefficients<double>& biquad);
+
+// These design the coefficients for a single band, in double precision and in SVF form.
+// They don't allocate, so the audio thread can use them to redesign a band while it is being smoothed.
+void designLowCut(ChainCoefficients& chainCoefficients, const ChainSettings& chainSettings, double sampleRate);
+void designPeak(ChainCoefficients& chainCoefficients, const ChainSettings& chainSettings, double sampleRate);
+void designHighCut(ChainCoefficients& chainCoefficients, const ChainSettings& chainSettings, double sampleRate);
+
+// Each slope step adds one more 12dB/Oct section, a bypassed cut has none
+int getNumActiveStages(Slope slope, bool bypassed);
+
+// How many samples the active sections keep ringing after the input stops, until they have decayed by TAIL_DECAY_DB.
+// Worked out from the pole radius of each section, and summed over the cascade since each one rings on the one before.
+double estimateTailSamples(const ChainCoefficients& chainCoefficients, double sampleRate);
+
+// Marks each cut whose designed response stays within toleranceDb of 0dB at every frequency of audibleBand as transparent.
+// The cuts in chainCoefficients have to be designed from chainSettings. Evaluates both cuts over the whole grid, so it belongs
+// wherever the designs are made, not on the audio thread. A negative tolerance marks neither.
+ChainSettings findTransparentCuts(ChainSettings chainSettings, const ChainCoefficients& chainCoefficients,
+                                  const FrequencyResponseEvaluator& audibleBand, float toleranceDb);
+
+// Marks every band that wouldn't change the sound as bypassed, so it drops out of the cascade entirely:
+// a peak within toleranceDb of 0dB, checked in closed form so it follows the gain while it glides, or a cut findTransparentCuts marked.
+// A negative tolerance leaves every band as it is.
+ChainSettings bypassTransparentBands(ChainSettings chainSettings, float toleranceDb);
 //==============================================================================
 /**
 */
-class SimpleEQAudioProcessor  : public juce::AudioProcessor
+class SimpleEQAudioProcessor  : public juce::AudioProcessor, juce::AudioProcessorParameter::Listener, juce::Timer
 {
 public:
     //==============================================================================
@@ -245,6 +360,11 @@ public:
     const juce::String getProgramName (int index) override;
     void changeProgramName (int index, const juce::String& newName) override;
 
+    //==============================================================================
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override { };
+    void timerCallback() override;
+
     //==============================================================================
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
@@ -256,17 +376,68 @@ public:
     using BlockType = juce::AudioBuffer<float>;
     SingleChannelSampleFifo<BlockType> leftChannelFifo{ Channel::Left };
     SingleChannelSampleFifo<BlockType> rightChannelFifo{ Channel::Right };
+
+    // processBlock only feeds the two fifos above while at least one analyzer is subscribed,
+    // so instances with no editor open, or with the analyzer switched off, skip the tap entirely.
+    // A subscriber is expected to throw away whatever was already waiting in the fifos, see PathProducer::requestReset.
+    void addAnalyzerSubscriber() { ++analyzerSubscribers; }
+    void removeAnalyzerSubscriber() { --analyzerSubscribers; }
+
+    // Timing and realtime safety counters for processBlock, safe to read from any thread
+    RealtimeStats::Snapshot getRealtimeStats() const { return realtimeStats.getSnapshot(); }
+    void resetRealtimeStats() { realtimeStats.reset(); }
+
+    // How close to neutral a band has to be before it is dropped from the cascade, see bypassTransparentBands
+    float getFlatBandTolerance() const { return flatBandToleranceDb.get(); }
+    void setFlatBandTolerance(float toleranceDb);
+
+    // How long frequency, gain and Q take to glide to a new value, and how many samples go by between redesigns while they do.
+    // The ramp length is picked up by the next prepareToPlay, the stride by the next block.
+    double getSmoothingRampSeconds() const { return smoothingRampSeconds.get(); }
+    int getSmoothingStrideSamples() const { return smoothingStrideSamples.get(); }
+    void setSmoothing(double rampSeconds, int strideSamples);
 private:
-    
-    // must create two chains, one for left and right audio for full stereo
-    MonoChain leftChain, rightChain;
 
-    void updatePeakFilter(const ChainSettings& chainSettings);
-    
-    void updateLowCutFilter(const ChainSettings& chainSettings);
-    void updateHighCutFilter(const ChainSettings& chainSettings);
+    // every band for every channel is run by the one cascade, the channels share the coefficients
+    FilterCascade filterCascade;
 
     void updateFilters();
+    void updateChangedFilters();
+    void applyPublishedCoefficients(bool jumpToTargets);
+    void applyBands(const ChainCoefficients& chainCoefficients, const ChainSettings& designSettings, bool lowCut, bool peak, bool highCut);
+    void processSmoothed(juce::AudioBuffer<float>& buffer, int numChannels);
+    static bool isSilent(const juce::AudioBuffer<float>& buffer, int numChannels);
+
+    // Dirty flags for each band, set by the parameter listener and cleared once the band has been redesigned.
+    // Ticks where no knob has moved skip coefficient design entirely.
+    juce::Atomic<bool> lowCutChanged{ true }, peakChanged{ true }, highCutChanged{ true };
+
+    // The dirty flag each parameter index sets, or nullptr for parameters that don't belong to a band. Filled in the constructor.
+    juce::Array<juce::Atomic<bool>*> parameterBandFlags;
+    juce::Atomic<bool>* getBandFlag(const juce::String& paramID);
+
+    // Coefficients are designed off the audio thread into designedCoefficients, then published through the triple buffer.
+    // The audio thread only ever acquires the latest slot and copies it into the cascade.
+    juce::CriticalSection designLock; // only serialises writers, the audio thread only takes it when rendering offline
+    ChainCoefficients designedCoefficients;
+    TripleBuffer<ChainCoefficients> coefficientBuffer;
+
+    // Audio thread only: ramps towards the published settings, redesigning the moving bands into smoothedCoefficients
+    ChainSmoother chainSmoother;
+    ChainCoefficients smoothedCoefficients;
+
+    // Worked out whenever the filters are redesigned, read by the host through getTailLengthSeconds
+    juce::Atomic<double> tailLengthSeconds{ 0.0 };
+
+    juce::Atomic<float> flatBandToleranceDb{ FLAT_BAND_TOLERANCE_DB };
+    juce::Atomic<double> smoothingRampSeconds{ SMOOTHING_RAMP_SECONDS };
+    juce::Atomic<int> smoothingStrideSamples{ SMOOTHING_STRIDE_SAMPLES };
+    // The grid findTransparentCuts checks the cuts over, only used under designLock
+    std::unique_ptr<FrequencyResponseEvaluator> audibleBand;
+
+    RealtimeStats realtimeStats;
+
+    juce::Atomic<int> analyzerSubscribers{ 0 };
 
     // Oscillator for testing spectrum analyzer
     //juce::dsp::Oscillator<float> osc;
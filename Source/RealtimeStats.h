@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    RealtimeStats.h
+    Created: 16 Oct 2026 5:03:18pm
+    Author:  Nate
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+
+// How close processBlock comes to its deadline, plus anything it does that it shouldn't (allocating, locking, denormals).
+// Only the audio thread writes, everything is an atomic so the editor or a dump can read it at any time without blocking.
+// A reader may see a block half way through being recorded, so fields of one snapshot can be one block apart.
+class RealtimeStats {
+public:
+    // Load is the time spent in processBlock as a percentage of the time the block lasts
+    static constexpr int NumLoadBuckets = 400;
+    static constexpr float LoadBucketWidth = 0.5f; // 0% to 200% in 0.5% steps, anything above lands in the last bucket
+
+    struct Snapshot {
+        juce::int64 numBlocks = 0;
+        juce::int64 numOverruns = 0; // blocks that took longer than they last
+        juce::int64 numAllocations = 0;
+        juce::int64 numLocks = 0;
+        juce::int64 numDenormals = 0;
+        float minLoad = 0.f, averageLoad = 0.f, maxLoad = 0.f, p99Load = 0.f;
+
+        juce::String toString() const {
+            juce::String str;
+            str << "load min " << juce::String(minLoad, 1) << "% avg " << juce::String(averageLoad, 1)
+                << "% p99 " << juce::String(p99Load, 1) << "% max " << juce::String(maxLoad, 1) << "%, "
+                << numOverruns << " overruns, " << numAllocations << " allocations, " << numLocks << " locks, "
+                << numDenormals << " denormals in " << numBlocks << " blocks";
+            return str;
+        }
+    };
+
+    //==============================================================================
+    // Audio thread
+
+    static juce::int64 getTimestamp() { return juce::Time::getHighResolutionTicks(); }
+
+    void blockFinished(juce::int64 startTimestamp, int numSamples, double sampleRate) {
+        juce::int64 elapsedTicks = getTimestamp() - startTimestamp;
+        if (numSamples <= 0 || sampleRate <= 0.0) {
+            return;
+        }
+
+        // resets are done here so there is only ever one writer
+        if (resetRequested.compareAndSetBool(false, true)) {
+            clear();
+        }
+
+        double blockSeconds = numSamples / sampleRate;
+        float load = (float)(100.0 * juce::Time::highResolutionTicksToSeconds(elapsedTicks) / blockSeconds);
+
+        juce::int64 blocks = numBlocks.get();
+        minLoad.set(blocks == 0 ? load : juce::jmin(minLoad.get(), load));
+        maxLoad.set(blocks == 0 ? load : juce::jmax(maxLoad.get(), load));
+        loadSum.set(loadSum.get() + load);
+        numBlocks.set(blocks + 1);
+
+        int bucket = juce::jlimit(0, NumLoadBuckets - 1, (int)(load / LoadBucketWidth));
+        loadHistogram[(size_t)bucket].set(loadHistogram[(size_t)bucket].get() + 1);
+
+        if (load > 100.f) {
+            numOverruns.set(numOverruns.get() + 1);
+        }
+    }
+
+    void addDenormals(int count) {
+        if (count > 0) {
+            numDenormals.set(numDenormals.get() + count);
+        }
+    }
+
+    // Marks the calling thread as this instance's audio thread for the lifetime of the scope,
+    // so the note functions below know which stats to count into
+    struct AudioThreadScope {
+        AudioThreadScope(RealtimeStats& stats) : previous(currentAudioThreadStats()) { currentAudioThreadStats() = &stats; }
+        ~AudioThreadScope() { currentAudioThreadStats() = previous; }
+    private:
+        RealtimeStats* previous;
+    };
+
+    // Safe to call from anywhere, they only count when called inside an AudioThreadScope.
+    // There is no portable allocation hook inside a plugin, so noteAllocation is called from
+    // a replacement operator new in executables that have one (the render tool).
+    static void noteAllocation() {
+        if (RealtimeStats* stats = currentAudioThreadStats()) {
+            stats->numAllocations.set(stats->numAllocations.get() + 1);
+        }
+    }
+
+    static void noteLock() {
+        if (RealtimeStats* stats = currentAudioThreadStats()) {
+            stats->numLocks.set(stats->numLocks.get() + 1);
+        }
+    }
+
+    //==============================================================================
+    // Any thread
+
+    Snapshot getSnapshot() const {
+        Snapshot snapshot;
+        snapshot.numBlocks = numBlocks.get();
+        snapshot.numOverruns = numOverruns.get();
+        snapshot.numAllocations = numAllocations.get();
+        snapshot.numLocks = numLocks.get();
+        snapshot.numDenormals = numDenormals.get();
+
+        if (snapshot.numBlocks > 0) {
+            snapshot.minLoad = minLoad.get();
+            snapshot.maxLoad = maxLoad.get();
+            snapshot.averageLoad = (float)(loadSum.get() / (double)snapshot.numBlocks);
+            snapshot.p99Load = getPercentileLoad(0.99);
+        }
+        return snapshot;
+    }
+
+    // Takes effect at the end of the next block
+    void reset() { resetRequested.set(true); }
+
+private:
+    juce::Atomic<juce::int64> numBlocks{ 0 }, numOverruns{ 0 }, numAllocations{ 0 }, numLocks{ 0 }, numDenormals{ 0 };
+    juce::Atomic<float> minLoad{ 0.f }, maxLoad{ 0.f };
+    juce::Atomic<double> loadSum{ 0.0 };
+    std::array<juce::Atomic<juce::int64>, NumLoadBuckets> loadHistogram;
+    juce::Atomic<bool> resetRequested{ false };
+
+    static RealtimeStats*& currentAudioThreadStats() {
+        static thread_local RealtimeStats* stats = nullptr;
+        return stats;
+    }
+
+    void clear() {
+        numBlocks.set(0);
+        numOverruns.set(0);
+        numAllocations.set(0);
+        numLocks.set(0);
+        numDenormals.set(0);
+        minLoad.set(0.f);
+        maxLoad.set(0.f);
+        loadSum.set(0.0);
+        for (juce::Atomic<juce::int64>& bucket : loadHistogram) {
+            bucket.set(0);
+        }
+    }
+
+    // Upper edge of the bucket the percentile falls in, so it errs high by at most one bucket width
+    float getPercentileLoad(double percentile) const {
+        juce::int64 total = 0;
+        for (const juce::Atomic<juce::int64>& bucket : loadHistogram) {
+            total += bucket.get();
+        }
+
+        juce::int64 threshold = (juce::int64)std::ceil(percentile * (double)total);
+        juce::int64 count = 0;
+        for (int i = 0; i < NumLoadBuckets; ++i) {
+            count += loadHistogram[(size_t)i].get();
+            if (count >= threshold) {
+                return (i + 1) * LoadBucketWidth;
+            }
+        }
+        return NumLoadBuckets * LoadBucketWidth;
+    }
+};